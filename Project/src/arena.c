@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/* rounds a size up to the arena's alignment */
+#define ARENA_ALIGN(n)	(((n) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+int arena_init(Arena* arena, size_t size) {
+
+	arena->base = (char *) malloc(size);
+	if (arena->base == NULL) {
+		arena->size = 0;
+		return 1;
+	}
+
+	arena->size = size;
+	arena->used = 0;
+	arena->high_water = 0;
+	arena->last = 0;
+	return 0;
+}
+
+void arena_destroy(Arena* arena) {
+
+	free(arena->base);
+	arena->base = NULL;
+	arena->size = 0;
+	arena->used = 0;
+	arena->last = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+
+	size = ARENA_ALIGN(size);
+	if (arena->base == NULL || size > arena->size - arena->used)
+		return NULL;
+
+	arena->last = arena->used;
+	arena->used += size;
+	if (arena->used > arena->high_water)
+		arena->high_water = arena->used;
+
+	return arena->base + arena->last;
+}
+
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+
+	if (ptr == NULL)
+		return arena_alloc(arena, new_size);
+
+	/* the last allocation just moves the arena's top */
+	if ((char *) ptr == arena->base + arena->last) {
+		size_t size = ARENA_ALIGN(new_size);
+		if (size > arena->size - arena->last)
+			return NULL;
+
+		arena->used = arena->last + size;
+		if (arena->used > arena->high_water)
+			arena->high_water = arena->used;
+		return ptr;
+	}
+
+	void* resized = arena_alloc(arena, new_size);
+	if (resized != NULL)
+		memcpy(resized, ptr, old_size < new_size ? old_size : new_size);
+
+	return resized;
+}
+
+int arena_contains(const Arena* arena, const void* ptr) {
+
+	return arena->base != NULL && (const char *) ptr >= arena->base
+			&& (const char *) ptr < arena->base + arena->size;
+}
+
+void arena_reset(Arena* arena) {
+
+	arena->used = 0;
+	arena->last = 0;
+}
+
+void arena_report(const Arena* arena, const char* name) {
+
+	printf("%s arena: %lu of %lu bytes used, high-water mark %lu bytes\n", name,
+			(unsigned long) arena->used, (unsigned long) arena->size,
+			(unsigned long) arena->high_water);
+}
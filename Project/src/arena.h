@@ -0,0 +1,100 @@
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <stddef.h>
+
+/**
+ * @file arena.h
+ */
+
+/**
+ *	@defgroup Arena
+ *	@{
+ *
+ *	Bump allocator over a single block of memory. Allocations are never
+ *	freed one by one: the whole arena is reset or destroyed at once, so
+ *	objects with the same lifetime end up contiguous and leave no holes
+ *	in the heap
+ */
+
+#define ARENA_ALIGNMENT	8	/**< Alignment of every allocation */
+
+/**
+ * @brief Bump allocator
+*/
+typedef struct Arena {
+	char* base;				/**< Arena's memory block */
+	size_t size;			/**< Arena's size in bytes */
+	size_t used;			/**< Bytes currently allocated */
+	size_t high_water;		/**< Maximum number of bytes ever allocated */
+	size_t last;			/**< Offset of the last allocation */
+} Arena;
+
+/**
+ *  @brief Arena initializer
+ *
+ *	@param arena Arena to be initialized
+ *	@param size Arena's size in bytes
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int arena_init(Arena* arena, size_t size);
+
+/**
+ *  @brief Arena destroyer
+ *
+ * 	Frees the arena's memory block, invalidating every allocation.
+ *
+ *	@param arena Arena to be destroyed
+ */
+void arena_destroy(Arena* arena);
+
+/**
+ *  @brief Allocates memory from an arena
+ *
+ *	@param arena Arena to allocate from
+ *	@param size Number of bytes to allocate
+ *	@return Returns pointer to the memory, NULL if the arena is full
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ *  @brief Resizes memory allocated from an arena
+ *
+ * 	The last allocation grows or shrinks in place. Any other allocation is
+ * 	copied to a new one, its old memory being reclaimed only on reset.
+ *
+ *	@param arena Arena the memory was allocated from
+ *	@param ptr Memory to be resized, may be NULL
+ *	@param old_size Memory's current size in bytes
+ *	@param new_size Memory's new size in bytes
+ *	@return Returns pointer to the resized memory, NULL if the arena is full
+ */
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+
+/**
+ *  @brief Tests whether some memory belongs to an arena
+ *
+ *	@param arena Arena to be tested
+ *	@param ptr Memory's address
+ *	@return Returns 1 if the memory was allocated from the arena and 0 otherwise
+ */
+int arena_contains(const Arena* arena, const void* ptr);
+
+/**
+ *  @brief Frees every allocation at once
+ *
+ *	@param arena Arena to be reset
+ */
+void arena_reset(Arena* arena);
+
+/**
+ *  @brief Prints an arena's usage and high-water mark
+ *
+ *	@param arena Arena to be reported
+ *	@param name Arena's name
+ */
+void arena_report(const Arena* arena, const char* name);
+
+/**@}*/
+
+#endif /* __ARENA_H */
@@ -0,0 +1,801 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "asset.h"
+#include "stbi_png.h"
+#include "png.h"
+#include "pack.h"
+#include "profile.h"
+#include "parallel.h"
+
+/**
+ * @brief PNG image's size and modification time, as stat() found them
+*/
+typedef struct Source {
+	char path[ASSET_PATH_MAX];	/**< PNG image's path */
+	int found;					/**< Whether stat() found the image */
+	uint32_t size;				/**< Image's size in bytes */
+	uint32_t mtime;				/**< Image's modification time */
+} Source;
+
+/**
+ * @brief Image decoded ahead by asset_preload(), until it's loaded
+*/
+typedef struct Preload {
+	char path[ASSET_PATH_MAX];	/**< PNG image's path */
+	Surface* surface;			/**< Decoded image, in the heap */
+} Preload;
+
+static Asset assets[MAX_ASSETS];	/**< Resident assets */
+static unsigned int n_assets = 0;	/**< Number of resident assets */
+static Arena asset_arena;			/**< Resident assets' memory */
+static Preload preloads[MAX_ASSETS];	/**< Images decoded ahead */
+static unsigned int n_preloads = 0;		/**< Number of images decoded ahead */
+static Source sources[2 * MAX_ASSETS];	/**< PNG images already stat()ed */
+static unsigned int n_sources = 0;		/**< Number of PNG images already stat()ed */
+
+/** Creates a surface in the arena, or in the heap once it's full */
+static Surface* asset_surface(Arena* arena, int width, int height) {
+
+	Surface* surface = NULL;
+	if (arena != NULL)
+		surface = surface_create_arena(arena, width, height);
+
+	return surface != NULL ? surface : surface_create(width, height);
+}
+
+/** Destroys a surface created by asset_surface() */
+static void asset_surface_destroy(Arena* arena, Surface* surface) {
+
+	if (arena == NULL || !arena_contains(arena, surface))
+		surface_destroy(surface);
+}
+
+void asset_raw_path(const char* png_path, char* raw_path, size_t size) {
+
+	size_t len = strlen(png_path);
+
+	if (len >= 4 && strcmp(png_path + len - 4, ".png") == 0)
+		len -= 4;
+
+	snprintf(raw_path, size, "%.*s.raw", (int) len, png_path);
+}
+
+/** Decodes a PNG with the streaming decoder, straight into its surface */
+static Surface* asset_stream_png(const char* png_path, Arena* arena) {
+
+	PngDecoder* decoder = png_open(png_path);
+	if (decoder == NULL)
+		return NULL;
+
+	Surface* surface = asset_surface(arena, decoder->width, decoder->height);
+	if (surface != NULL && png_decode(decoder, surface) != 0) {
+		printf("PNG image \"%s\" is corrupt!\n", png_path);
+		asset_surface_destroy(arena, surface);
+		surface = NULL;
+	}
+
+	png_close(decoder);
+	return surface;
+}
+
+/** Decodes a PNG with stb_image, then converts it into a surface */
+static Surface* asset_stb_png(const char* png_path, Arena* arena) {
+
+	int width, height;
+	unsigned char* image = stbi_png_load(&width, &height, png_path);
+	if (image == NULL)
+		return NULL;
+
+	Surface* surface = asset_surface(arena, width, height);
+	if (surface == NULL) {
+		stbi_free(image);
+		return NULL;
+	}
+
+	/* RGB to the native BGR */
+	int x, y;
+	const unsigned char* rgb = image;
+	for (y = 0; y < height; y++) {
+		char* pixel = surface->pixels + y * surface->pitch;
+		for (x = 0; x < width; x++, rgb += 3, pixel += SURFACE_BYTES_PER_PIXEL) {
+			pixel[0] = rgb[2];
+			pixel[1] = rgb[1];
+			pixel[2] = rgb[0];
+		}
+	}
+
+	stbi_free(image);
+	return surface;
+}
+
+#ifdef PNG_VERIFY
+/** Decodes a PNG with stb_image too, keeping stb_image's pixels if they differ */
+static void asset_verify_png(const char* png_path, Surface* surface) {
+
+	Surface* reference = asset_stb_png(png_path, NULL);
+	if (reference == NULL)
+		return;
+
+	if (reference->width != surface->width || reference->height != surface->height) {
+		printf("PNG image \"%s\" has a different size in stb_image!\n", png_path);
+		surface_destroy(reference);
+		return;
+	}
+
+	int y, same = 1;
+	for (y = 0; same && y < surface->height; y++)
+		same = memcmp(surface->pixels + y * surface->pitch,
+				reference->pixels + y * reference->pitch,
+				surface->width * SURFACE_BYTES_PER_PIXEL) == 0;
+
+	if (!same) {
+		printf("PNG image \"%s\" decodes differently from stb_image!\n", png_path);
+		for (y = 0; y < surface->height; y++)
+			memcpy(surface->pixels + y * surface->pitch,
+					reference->pixels + y * reference->pitch,
+					surface->width * SURFACE_BYTES_PER_PIXEL);
+	}
+
+	surface_destroy(reference);
+}
+#endif
+
+Surface* asset_decode_png(const char* png_path, Arena* arena) {
+
+	Surface* surface = asset_stream_png(png_path, arena);
+#ifdef PNG_VERIFY
+	if (surface != NULL)
+		asset_verify_png(png_path, surface);
+#endif
+	if (surface != NULL)
+		return surface;
+
+	/* stb_image handles what the streaming decoder doesn't */
+	return asset_stb_png(png_path, arena);
+}
+
+/** Tests whether a raw asset's header is valid, native or indexed as per its magic */
+static int asset_header_valid(const AssetHeader* header, uint32_t magic) {
+
+	/* indexed assets store 1 byte per pixel, patches are native */
+	int bytes_per_pixel = magic == ASSET_INDEXED_MAGIC ? 1 : SURFACE_BYTES_PER_PIXEL;
+
+	return header->magic == magic && header->version == ASSET_VERSION
+			&& header->width > 0 && header->height > 0
+			&& header->pitch == header->width * bytes_per_pixel;
+}
+
+/** Reads a PNG image's size and modification time */
+static void asset_stat(const char* png_path, Source* source) {
+
+	struct stat info;
+	snprintf(source->path, ASSET_PATH_MAX, "%s", png_path);
+	source->found = stat(png_path, &info) == 0;
+	source->size = source->found ? (uint32_t) info.st_size : 0;
+	source->mtime = source->found ? (uint32_t) info.st_mtime : 0;
+}
+
+/** Finds a PNG image's size and modification time, stat()ing each image once.
+ * Main thread only, workers stat() their images themselves */
+static const Source* asset_source(const char* png_path, Source* uncached) {
+
+	unsigned int i;
+	for (i = 0; i < n_sources; i++)
+		if (strcmp(sources[i].path, png_path) == 0)
+			return &sources[i];
+
+	Source* source = n_sources < 2 * MAX_ASSETS ? &sources[n_sources++] : uncached;
+	asset_stat(png_path, source);
+	return source;
+}
+
+/** Tests whether the PNG a raw asset was converted from changed since */
+static int asset_stale(const AssetHeader* header, const Source* source) {
+
+	return source->found && (source->size != header->source_size
+			|| source->mtime != header->source_mtime);
+}
+
+Surface* asset_read_raw(const char* raw_path, const char* png_path, Arena* arena) {
+
+	int fd = open(raw_path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	AssetHeader header;
+	if (read(fd, &header, sizeof(AssetHeader)) != sizeof(AssetHeader)
+			|| !asset_header_valid(&header, ASSET_MAGIC)) {
+		printf("Raw asset \"%s\" is corrupt!\n", raw_path);
+		close(fd);
+		return NULL;
+	}
+
+	Source source;
+	asset_stat(png_path, &source);
+	if (asset_stale(&header, &source)) {
+		printf("Raw asset \"%s\" is stale!\n", raw_path);
+		close(fd);
+		return NULL;
+	}
+
+	Surface* surface = asset_surface(arena, header.width, header.height);
+	if (surface == NULL) {
+		close(fd);
+		return NULL;
+	}
+
+	/* pixels are stored as they're laid out in memory */
+	ssize_t n_bytes = (ssize_t) header.pitch * header.height;
+	if (read(fd, surface->pixels, n_bytes) != n_bytes) {
+		printf("Raw asset \"%s\" is truncated!\n", raw_path);
+		asset_surface_destroy(arena, surface);
+		close(fd);
+		return NULL;
+	}
+
+	close(fd);
+	return surface;
+}
+
+int asset_make_header(AssetHeader* header, const Surface* surface, const char* png_path) {
+
+	struct stat source;
+	if (stat(png_path, &source) != 0) {
+		printf("Couldn't stat \"%s\"!\n", png_path);
+		return 1;
+	}
+
+	header->magic = ASSET_MAGIC;
+	header->version = ASSET_VERSION;
+	header->width = surface->width;
+	header->height = surface->height;
+	header->pitch = surface->pitch;
+	header->source_size = source.st_size;
+	header->source_mtime = source.st_mtime;
+	return 0;
+}
+
+int asset_write_raw(const Surface* surface, const char* raw_path, const char* png_path) {
+
+	AssetHeader header;
+	if (asset_make_header(&header, surface, png_path) != 0)
+		return 1;
+
+	FILE* file = fopen(raw_path, "wb");
+	if (file == NULL) {
+		printf("Couldn't create \"%s\"!\n", raw_path);
+		return 1;
+	}
+
+	size_t n_bytes = (size_t) surface->pitch * surface->height;
+	if (fwrite(&header, sizeof(AssetHeader), 1, file) != 1
+			|| fwrite(surface->pixels, 1, n_bytes, file) != n_bytes) {
+		printf("Couldn't write \"%s\"!\n", raw_path);
+		fclose(file);
+		return 1;
+	}
+
+	return fclose(file) != 0;
+}
+
+/** Loads an image from its raw twin or its PNG */
+static Surface* asset_load_file(const char* png_path, Arena* arena) {
+
+	char raw_path[ASSET_PATH_MAX];
+	asset_raw_path(png_path, raw_path, ASSET_PATH_MAX);
+
+	Surface* surface = asset_read_raw(raw_path, png_path, arena);
+	if (surface != NULL)
+		return surface;
+
+	/* no up to date raw asset, fall back to decoding */
+	return asset_decode_png(png_path, arena);
+}
+
+Surface* asset_load(const char* png_path, Arena* arena) {
+
+	/* images decoded ahead are handed over once */
+	size_t i;
+	for (i = 0; i < n_preloads; i++) {
+		if (preloads[i].surface != NULL && strcmp(preloads[i].path, png_path) == 0) {
+			Surface* surface = preloads[i].surface;
+			preloads[i].surface = NULL;
+			return surface;
+		}
+	}
+
+	return asset_load_file(png_path, arena);
+}
+
+/** Finds a resident asset, registering it if needed */
+static Asset* asset_find(const char* png_path, asset_format_t format) {
+
+	size_t i;
+	for (i = 0; i < n_assets; i++)
+		if (assets[i].format == format && strcmp(assets[i].path, png_path) == 0)
+			return &assets[i];
+
+	if (n_assets == MAX_ASSETS) {
+		printf("Too many assets to load \"%s\"!\n", png_path);
+		return NULL;
+	}
+
+	Asset* asset = &assets[n_assets++];
+	snprintf(asset->path, ASSET_PATH_MAX, "%s", png_path);
+	asset->format = format;
+	asset->base[0] = '\0';
+	asset->surface = NULL;
+	asset->indexed = NULL;
+	asset->patch = NULL;
+	asset->refcount = 0;
+	asset->failed = 0;
+	return asset;
+}
+
+/** Finds an image of the asset pack, named after the PNG's file name */
+static const AssetHeader* asset_pack_image(const char* png_path, pack_format_t format) {
+
+	const char* name = strrchr(png_path, '/');
+	name = name != NULL ? name + 1 : png_path;
+
+	size_t size;
+	const AssetHeader* header = (const AssetHeader *) pack_get(name, format, &size);
+	if (header == NULL)
+		return NULL;
+
+	/* what's stored between the header and the pixels */
+	Source uncached;
+	uint32_t magic = ASSET_MAGIC;
+	size_t extra = 0;
+	if (format == PACK_INDEXED) {
+		magic = ASSET_INDEXED_MAGIC;
+		extra = INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL;
+	} else if (format == PACK_PATCH) {
+		magic = ASSET_PATCH_MAGIC;
+		extra = sizeof(PatchHeader) - sizeof(AssetHeader);
+	}
+
+	if (size < sizeof(AssetHeader) || !asset_header_valid(header, magic)
+			|| size - sizeof(AssetHeader) < extra + (size_t) header->pitch * header->height
+			|| asset_stale(header, asset_source(png_path, &uncached)))
+		return NULL;
+
+	return header;
+}
+
+/** Wraps an indexed image of the asset pack without copying it */
+static IndexedSurface* asset_indexed_from_pack(const char* png_path) {
+
+	const AssetHeader* header = asset_pack_image(png_path, PACK_INDEXED);
+	if (header == NULL)
+		return NULL;
+
+	IndexedSurface* indexed = (IndexedSurface *) arena_alloc(&asset_arena,
+			sizeof(IndexedSurface));
+	if (indexed == NULL)
+		return NULL;
+
+	indexed->width = header->width;
+	indexed->height = header->height;
+	indexed->pitch = header->pitch;
+	indexed->n_colors = INDEXED_COLORS;
+	indexed->palette = (uint8_t *) (header + 1);
+	indexed->indices = indexed->palette + INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL;
+	return indexed;
+}
+
+/** Wraps an image of the asset pack in a surface without copying its
+ * pixels, indexed images are expanded into the arena */
+static Surface* asset_from_pack(const char* png_path) {
+
+	const AssetHeader* header = asset_pack_image(png_path, PACK_IMAGE);
+	if (header == NULL) {
+		IndexedSurface* indexed = asset_indexed_from_pack(png_path);
+		if (indexed == NULL)
+			return NULL;
+
+		Surface* surface = asset_surface(&asset_arena, indexed->width, indexed->height);
+		if (surface != NULL)
+			indexed_blit(surface, indexed, 0, 0, indexed->width, indexed->height, 0, 0);
+		return surface;
+	}
+
+	Surface* surface = (Surface *) arena_alloc(&asset_arena, sizeof(Surface));
+	if (surface == NULL)
+		return NULL;
+
+	surface->width = header->width;
+	surface->height = header->height;
+	surface->pitch = header->pitch;
+	surface->pixels = (char *) (header + 1);
+	return surface;
+}
+
+/** Loads an image as an indexed surface */
+static IndexedSurface* asset_load_indexed(const char* png_path) {
+
+	IndexedSurface* indexed = asset_indexed_from_pack(png_path);
+	if (indexed != NULL)
+		return indexed;
+
+	/* native images are only kept until they're indexed */
+	Surface* surface = asset_from_pack(png_path);
+	int packed = surface != NULL;
+	if (!packed)
+		surface = asset_load(png_path, NULL);
+	if (surface == NULL)
+		return NULL;
+
+	indexed = surface_index(surface, &asset_arena, 1);
+	if (indexed == NULL)
+		indexed = surface_index(surface, NULL, 1);
+
+	if (!packed)
+		surface_destroy(surface);
+	return indexed;
+}
+
+Patch* asset_make_patch(const Surface* variant, int x, int y, int width,
+		int height, Arena* arena) {
+
+	/* the patch, its surface and its pixels are a single allocation */
+	size_t pitch = width * SURFACE_BYTES_PER_PIXEL;
+	size_t size = sizeof(Patch) + sizeof(Surface) + pitch * height;
+	Patch* patch = (Patch *) (arena != NULL ? arena_alloc(arena, size) : NULL);
+	if (patch == NULL && (patch = (Patch *) malloc(size)) == NULL)
+		return NULL;
+
+	patch->x = x;
+	patch->y = y;
+	patch->pixels = (Surface *) (patch + 1);
+	patch->pixels->width = width;
+	patch->pixels->height = height;
+	patch->pixels->pitch = pitch;
+	patch->pixels->pixels = (char *) (patch->pixels + 1);
+	surface_blit(patch->pixels, variant, x, y, width, height, 0, 0);
+	return patch;
+}
+
+/** Wraps a patch of the asset pack without copying its pixels */
+static Patch* asset_patch_from_pack(const char* png_path) {
+
+	const PatchHeader* header = (const PatchHeader *) asset_pack_image(png_path,
+			PACK_PATCH);
+	if (header == NULL)
+		return NULL;
+
+	Patch* patch = (Patch *) arena_alloc(&asset_arena, sizeof(Patch) + sizeof(Surface));
+	if (patch == NULL)
+		return NULL;
+
+	patch->x = header->x;
+	patch->y = header->y;
+	patch->pixels = (Surface *) (patch + 1);
+	patch->pixels->width = header->image.width;
+	patch->pixels->height = header->image.height;
+	patch->pixels->pitch = header->image.pitch;
+	patch->pixels->pixels = (char *) (header + 1);
+	return patch;
+}
+
+/** Loads an image as a patch of its base image */
+static Patch* asset_load_patch(const char* png_path, const char* base_path) {
+
+	Patch* patch = asset_patch_from_pack(png_path);
+	if (patch != NULL)
+		return patch;
+
+	IndexedSurface* base = asset_acquire_indexed(base_path);
+	if (base == NULL)
+		return NULL;
+
+	/* the variant is only kept until it's diffed against its base */
+	Surface packed, *variant = NULL;
+	const AssetHeader* header = asset_pack_image(png_path, PACK_IMAGE);
+	IndexedSurface* indexed = NULL;
+	if (header != NULL) {
+		packed.width = header->width;
+		packed.height = header->height;
+		packed.pitch = header->pitch;
+		packed.pixels = (char *) (header + 1);
+		variant = &packed;
+	} else if ((indexed = asset_indexed_from_pack(png_path)) != NULL) {
+		variant = surface_create(indexed->width, indexed->height);
+		if (variant != NULL)
+			indexed_blit(variant, indexed, 0, 0, indexed->width, indexed->height, 0, 0);
+	} else
+		variant = asset_load(png_path, NULL);
+
+	if (variant != NULL && variant->width == base->width
+			&& variant->height == base->height) {
+		int x = 0, y = 0, width = 0, height = 0;
+		indexed_diff_rect(base, variant, &x, &y, &width, &height);
+		/* the arena was sized before the diff, so the patch goes to the heap */
+		patch = asset_make_patch(variant, x, y, width, height, NULL);
+	} else if (variant != NULL)
+		printf("\"%s\" isn't the size of \"%s\"!\n", png_path, base_path);
+
+	if (variant != &packed)
+		surface_destroy(variant);
+	asset_release(base);
+	return patch;
+}
+
+/** Reads an image's size from the asset pack, its raw twin or its PNG's header */
+static int asset_image_size(const char* png_path, int* width, int* height) {
+
+	const AssetHeader* packed = asset_pack_image(png_path, PACK_IMAGE);
+	if (packed == NULL)
+		packed = asset_pack_image(png_path, PACK_INDEXED);
+	if (packed != NULL) {
+		*width = packed->width;
+		*height = packed->height;
+		return 0;
+	}
+
+	char raw_path[ASSET_PATH_MAX];
+	asset_raw_path(png_path, raw_path, ASSET_PATH_MAX);
+	int fd = open(raw_path, O_RDONLY);
+	if (fd >= 0) {
+		AssetHeader header;
+		int valid = read(fd, &header, sizeof(AssetHeader)) == sizeof(AssetHeader)
+				&& asset_header_valid(&header, ASSET_MAGIC);
+		close(fd);
+		if (valid) {
+			*width = header.width;
+			*height = header.height;
+			return 0;
+		}
+	}
+
+	size_t size;
+	return png_info(png_path, width, height, &size);
+}
+
+/** Bounds the arena memory a registered asset takes once it's loaded */
+static size_t asset_footprint(const Asset* asset) {
+
+	/* the pack's images are used in place, only their headers are allocated */
+	size_t headers = sizeof(Patch) + sizeof(Surface) + sizeof(IndexedSurface)
+			+ 4 * ARENA_ALIGNMENT;
+	pack_format_t format = asset->format == ASSET_INDEXED ? PACK_INDEXED
+			: asset->format == ASSET_PATCH ? PACK_PATCH : PACK_IMAGE;
+	if (asset_pack_image(asset->path, format) != NULL)
+		return headers;
+
+	/* patches diffed at load time are only sized then, so they're kept in the heap */
+	if (asset->format == ASSET_PATCH)
+		return headers;
+
+	/* images decoded ahead stay in the heap */
+	size_t i;
+	for (i = 0; asset->format == ASSET_NATIVE && i < n_preloads; i++)
+		if (preloads[i].surface != NULL && strcmp(preloads[i].path, asset->path) == 0)
+			return headers;
+
+	int width, height;
+	if (asset_image_size(asset->path, &width, &height) != 0)
+		return headers;
+
+	size_t n_pixels = (size_t) width * height;
+	if (asset->format == ASSET_INDEXED)
+		return headers + INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL + n_pixels;
+
+	return headers + n_pixels * SURFACE_BYTES_PER_PIXEL;
+}
+
+/** Creates the asset arena, sized for every asset registered so far */
+static void asset_arena_init() {
+
+	size_t size = 0, i;
+	for (i = 0; i < n_assets; i++)
+		size += asset_footprint(&assets[i]);
+
+	if (arena_init(&asset_arena, size) != 0)
+		printf("Couldn't allocate the asset arena!\n");
+}
+
+/** Tests whether a registered asset is loaded */
+static int asset_loaded(const Asset* asset) {
+
+	return asset->surface != NULL || asset->indexed != NULL || asset->patch != NULL;
+}
+
+/** Loads a registered asset, if it isn't loaded yet */
+static int asset_resolve(Asset* asset) {
+
+	if (!asset_loaded(asset) && !asset->failed) {
+		if (asset_arena.base == NULL)
+			asset_arena_init();
+
+		const char* name = strrchr(asset->path, '/');
+		int phase = profile_begin(name != NULL ? name + 1 : asset->path);
+
+		if (asset->format == ASSET_INDEXED) {
+			asset->indexed = asset_load_indexed(asset->path);
+			asset->failed = asset->indexed == NULL;
+		} else if (asset->format == ASSET_PATCH) {
+			asset->patch = asset_load_patch(asset->path, asset->base);
+			asset->failed = asset->patch == NULL;
+		} else {
+			/* the pack's images are used in place */
+			asset->surface = asset_from_pack(asset->path);
+			if (asset->surface == NULL)
+				asset->surface = asset_load(asset->path, &asset_arena);
+			asset->failed = asset->surface == NULL;
+		}
+
+		profile_end(phase);
+	}
+
+	return !asset->failed;
+}
+
+Surface* asset_acquire(const char* png_path) {
+
+	Asset* asset = asset_find(png_path, ASSET_NATIVE);
+	if (asset == NULL || !asset_resolve(asset))
+		return NULL;
+
+	asset->refcount++;
+	return asset->surface;
+}
+
+IndexedSurface* asset_acquire_indexed(const char* png_path) {
+
+	Asset* asset = asset_find(png_path, ASSET_INDEXED);
+	if (asset == NULL || !asset_resolve(asset))
+		return NULL;
+
+	asset->refcount++;
+	return asset->indexed;
+}
+
+/** Finds a resident patch, registering it along with its base if needed */
+static Asset* asset_find_patch(const char* png_path, const char* base_path) {
+
+	Asset* asset = asset_find(png_path, ASSET_PATCH);
+	if (asset != NULL && asset->base[0] == '\0')
+		snprintf(asset->base, ASSET_PATH_MAX, "%s", base_path);
+
+	return asset;
+}
+
+Patch* asset_acquire_patch(const char* png_path, const char* base_path) {
+
+	Asset* asset = asset_find_patch(png_path, base_path);
+	if (asset == NULL || !asset_resolve(asset))
+		return NULL;
+
+	asset->refcount++;
+	return asset->patch;
+}
+
+void asset_release(const void* image) {
+
+	if (image == NULL)
+		return;
+
+	size_t i;
+	for (i = 0; i < n_assets; i++) {
+		if (assets[i].surface == image || assets[i].indexed == image
+				|| assets[i].patch == image) {
+			if (assets[i].refcount > 0)
+				assets[i].refcount--;
+			return;
+		}
+	}
+}
+
+int asset_defer(const char* png_path, asset_format_t format) {
+
+	return asset_find(png_path, format) == NULL;
+}
+
+int asset_defer_patch(const char* png_path, const char* base_path) {
+
+	return asset_find_patch(png_path, base_path) == NULL;
+}
+
+unsigned int asset_idle() {
+
+	unsigned int n_pending = 0;
+	int loaded = 0;
+
+	size_t i;
+	for (i = 0; i < n_assets; i++) {
+		if (asset_loaded(&assets[i]) || assets[i].failed)
+			continue;
+
+		/* one asset per call, the others are only counted */
+		if (!loaded) {
+			asset_resolve(&assets[i]);
+			loaded = 1;
+		} else
+			n_pending++;
+	}
+
+	/* decoding memory isn't needed anymore */
+	if (n_pending == 0)
+		stbi_png_cleanup();
+
+	return n_pending;
+}
+
+/** Decodes an image ahead, on a worker thread */
+static void asset_preload_task(void* context, unsigned int index) {
+
+	Preload* preload = (Preload *) context + index;
+	preload->surface = asset_load_file(preload->path, NULL);
+
+	/* the worker's own decoding memory */
+	stbi_png_cleanup();
+}
+
+unsigned int asset_preload() {
+
+	/* registered images not loaded yet, once each, unless they're packed */
+	size_t i, j;
+	n_preloads = 0;
+	for (i = 0; i < n_assets; i++) {
+		if (asset_loaded(&assets[i]) || assets[i].failed)
+			continue;
+
+		const char* name = strrchr(assets[i].path, '/');
+		if (pack_contains(name != NULL ? name + 1 : assets[i].path))
+			continue;
+
+		for (j = 0; j < n_preloads; j++)
+			if (strcmp(preloads[j].path, assets[i].path) == 0)
+				break;
+		if (j == n_preloads)
+			/* both are ASSET_PATH_MAX long, the asset's null-terminated */
+			memcpy(preloads[n_preloads++].path, assets[i].path, ASSET_PATH_MAX);
+	}
+
+	int phase = profile_begin("asset_preload");
+	parallel_run(n_preloads, asset_preload_task, preloads);
+	profile_end(phase);
+
+	/* every image is decoded, converting them is quick */
+	unsigned int n_loaded = 0;
+	for (i = 0; i < n_assets; i++) {
+		if (asset_loaded(&assets[i]) || assets[i].failed)
+			continue;
+		n_loaded += asset_resolve(&assets[i]);
+	}
+
+	/* images nothing was loaded from */
+	for (i = 0; i < n_preloads; i++)
+		surface_destroy(preloads[i].surface);
+	n_preloads = 0;
+
+	return n_loaded;
+}
+
+void asset_free_all() {
+
+	size_t i;
+	for (i = 0; i < n_assets; i++) {
+		if (assets[i].refcount > 0)
+			printf("Asset \"%s\" freed while still in use!\n", assets[i].path);
+		asset_surface_destroy(&asset_arena, assets[i].surface);
+		if (assets[i].indexed != NULL && !arena_contains(&asset_arena, assets[i].indexed))
+			indexed_destroy(assets[i].indexed);
+		if (assets[i].patch != NULL && !arena_contains(&asset_arena, assets[i].patch))
+			free(assets[i].patch);
+	}
+
+	n_assets = 0;
+	n_sources = 0;
+	stbi_png_cleanup();
+	if (asset_arena.base != NULL) {
+		arena_report(&asset_arena, "Asset");
+		arena_destroy(&asset_arena);
+	}
+}
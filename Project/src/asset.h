@@ -0,0 +1,275 @@
+#ifndef __ASSET_H
+#define __ASSET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "surface.h"
+
+/**
+ * @file asset.h
+ */
+
+/**
+ *	@defgroup Asset
+ *	@{
+ *
+ *	Image assets. Each PNG may have a precompiled ".raw" twin, either in the
+ *	asset pack or next to it, already in the framebuffer's native format,
+ *	which is used instead of decoding the PNG. The PNG is decoded when its
+ *	twin is missing or older than the PNG itself.
+ *
+ *	Loaded assets stay resident until asset_free_all(), so acquiring an
+ *	asset again never decodes nor allocates it twice. Resident assets are
+ *	stored contiguously in a single arena, sized when the first one is
+ *	loaded from the sizes of every asset registered by then. Assets that
+ *	don't fit in it, and patches diffed at load time, are allocated from
+ *	the heap. Assets not needed right away may be deferred and loaded
+ *	later, while the game is idle.
+ *
+ *	Large flat-shaded images may be acquired as indexed surfaces instead,
+ *	taking a third of the memory, either stored indexed in the asset pack
+ *	or indexed once loaded. Variants of an image differing from it in a small
+ *	area, such as the menu's hovered buttons, are kept as patches instead:
+ *	only the rectangle where they differ is stored
+ */
+
+#define ASSET_MAGIC		0x414b4e53	/**< Raw asset's magic number ("SNKA") */
+#define ASSET_INDEXED_MAGIC	0x494b4e53	/**< Indexed raw asset's magic number ("SNKI") */
+#define ASSET_PATCH_MAGIC	0x504b4e53	/**< Raw patch's magic number ("SNKP") */
+#define ASSET_VERSION	1			/**< Raw asset format's version */
+#define ASSET_PATH_MAX	256			/**< Maximum length of an asset's path */
+#define MAX_ASSETS		16			/**< Maximum number of resident assets */
+
+/**
+ * @brief Raw asset's header, followed by the surface's pixels, or by the
+ * palette's INDEXED_COLORS colors and the indices for an indexed asset
+*/
+typedef struct AssetHeader {
+	uint32_t magic;				/**< Must be ASSET_MAGIC */
+	uint32_t version;			/**< Must be ASSET_VERSION */
+	int32_t width;				/**< Image's width */
+	int32_t height;				/**< Image's height */
+	int32_t pitch;				/**< Image's row size in bytes */
+	uint32_t source_size;		/**< Size of the PNG it was converted from */
+	uint32_t source_mtime;		/**< Modification time of the PNG it was converted from */
+} AssetHeader;
+
+/**
+ * @brief Raw patch's header, followed by the patch's pixels
+*/
+typedef struct PatchHeader {
+	AssetHeader image;			/**< Patch's image, magic ASSET_PATCH_MAGIC */
+	int32_t x;					/**< Patch's left-upper corner x coordinate in the base image */
+	int32_t y;					/**< Patch's left-upper corner y coordinate in the base image */
+} PatchHeader;
+
+/**
+ * @brief Rectangle where an image differs from its base image
+*/
+typedef struct Patch {
+	int x;						/**< Patch's left-upper corner x coordinate */
+	int y;						/**< Patch's left-upper corner y coordinate */
+	Surface* pixels;			/**< Patch's pixels, empty if both images are equal */
+} Patch;
+
+/**
+ * @brief Formats assets are kept resident in
+*/
+typedef enum { ASSET_NATIVE, ASSET_INDEXED, ASSET_PATCH } asset_format_t;
+
+/**
+ * @brief Resident asset
+*/
+typedef struct Asset {
+	char path[ASSET_PATH_MAX];	/**< PNG image's path, identifying the asset with its format */
+	asset_format_t format;		/**< Format the asset is kept in */
+	char base[ASSET_PATH_MAX];	/**< Base image's path, for a patch */
+	Surface* surface;			/**< Asset's native image, NULL while deferred */
+	IndexedSurface* indexed;	/**< Asset's indexed image, NULL while deferred */
+	Patch* patch;				/**< Asset's patch, NULL while deferred */
+	unsigned int refcount;		/**< Number of handles acquired and not released */
+	int failed;					/**< Whether loading the asset failed */
+} Asset;
+
+/**
+ *  @brief Computes the path of a PNG's raw twin
+ *
+ * 	Replaces the ".png" extension with ".raw", or appends it.
+ *
+ *	@param png_path PNG image's path
+ *	@param raw_path Buffer to store the raw asset's path
+ *	@param size Buffer's size
+ */
+void asset_raw_path(const char* png_path, char* raw_path, size_t size);
+
+/**
+ *  @brief Decodes a PNG image into a native-format surface
+ *
+ *	@param png_path PNG image's path
+ *	@param arena Arena to allocate the surface from, NULL for the heap
+ *	@return Returns pointer to the surface, NULL on failure
+ */
+Surface* asset_decode_png(const char* png_path, Arena* arena);
+
+/**
+ *  @brief Reads a raw asset
+ *
+ * 	The asset is rejected if it's corrupt or if the PNG it was converted
+ * 	from changed since. A missing PNG doesn't invalidate it.
+ *
+ *	@param raw_path Raw asset's path
+ *	@param png_path Path of the PNG it was converted from
+ *	@param arena Arena to allocate the surface from, NULL for the heap
+ *	@return Returns pointer to the surface, NULL if missing or stale
+ */
+Surface* asset_read_raw(const char* raw_path, const char* png_path, Arena* arena);
+
+/**
+ *  @brief Fills a raw asset's header
+ *
+ *	@param header Header to be filled
+ *	@param surface Surface to be written as a raw asset
+ *	@param png_path Path of the PNG it was converted from
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int asset_make_header(AssetHeader* header, const Surface* surface, const char* png_path);
+
+/**
+ *  @brief Writes a surface as a raw asset
+ *
+ *	@param surface Surface to be written
+ *	@param raw_path Raw asset's path
+ *	@param png_path Path of the PNG it was converted from
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int asset_write_raw(const Surface* surface, const char* raw_path, const char* png_path);
+
+/**
+ *  @brief Loads an image asset
+ *
+ * 	Reads the PNG's raw twin when it's up to date, decoding the PNG
+ * 	otherwise. The surface is allocated from the heap when the arena
+ * 	is full.
+ *
+ *	@param png_path PNG image's path
+ *	@param arena Arena to allocate the surface from, NULL for the heap
+ *	@return Returns pointer to the surface, NULL on failure
+ */
+Surface* asset_load(const char* png_path, Arena* arena);
+
+/**
+ *  @brief Acquires a handle to an image asset
+ *
+ * 	Loads the asset the first time it's acquired, or if it was deferred
+ * 	and isn't loaded yet: images in the asset pack are used in place,
+ * 	others are loaded with asset_load(). Later acquisitions return
+ * 	the same surface, which mustn't be modified.
+ *
+ *	@param png_path PNG image's path
+ *	@return Returns pointer to the asset's surface, NULL on failure
+ */
+Surface* asset_acquire(const char* png_path);
+
+/**
+ *  @brief Acquires a handle to an image asset, as an indexed surface
+ *
+ * 	Same as asset_acquire(). Indexed images in the asset pack are used in
+ * 	place, others are indexed once loaded, quantized if they have too
+ * 	many colors.
+ *
+ *	@param png_path PNG image's path
+ *	@return Returns pointer to the asset's indexed surface, NULL on failure
+ */
+IndexedSurface* asset_acquire_indexed(const char* png_path);
+
+/**
+ *  @brief Creates a patch from a rectangle of an image
+ *
+ *	@param variant Image to copy the rectangle from
+ *	@param x Rectangle's left-upper corner x coordinate
+ *	@param y Rectangle's left-upper corner y coordinate
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ *	@param arena Arena to allocate from, NULL for the heap
+ *	@return Returns pointer to the patch, NULL on failure
+ */
+Patch* asset_make_patch(const Surface* variant, int x, int y, int width,
+		int height, Arena* arena);
+
+/**
+ *  @brief Acquires a handle to an image asset, as a patch of another image
+ *
+ * 	Same as asset_acquire(). Patches in the asset pack are used in place,
+ * 	other images are diffed against their base, acquired indexed, once
+ * 	loaded. Only the patch stays resident.
+ *
+ *	@param png_path PNG image's path
+ *	@param base_path Path of the PNG image it's a variant of
+ *	@return Returns pointer to the patch, NULL on failure
+ */
+Patch* asset_acquire_patch(const char* png_path, const char* base_path);
+
+/**
+ *  @brief Releases a handle acquired with asset_acquire(),
+ *  asset_acquire_indexed() or asset_acquire_patch()
+ *
+ * 	The asset stays resident, ready to be acquired again. Surfaces not
+ * 	acquired from the asset manager, including NULL, are ignored.
+ *
+ *	@param image Asset's surface, indexed surface or patch
+ */
+void asset_release(const void* image);
+
+/**
+ *  @brief Defers loading an image asset
+ *
+ * 	The asset is registered without being loaded. It's loaded by
+ * 	asset_idle(), or when first acquired if that happens sooner.
+ *
+ *	@param png_path PNG image's path
+ *	@param format Format the asset will be acquired in
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int asset_defer(const char* png_path, asset_format_t format);
+
+/**
+ *  @brief Defers loading an image asset, as a patch of another image
+ *
+ *	@param png_path PNG image's path
+ *	@param base_path Path of the PNG image it's a variant of
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int asset_defer_patch(const char* png_path, const char* base_path);
+
+/**
+ *  @brief Loads the next deferred asset
+ *
+ * 	Meant to be called while the game is idle, loading one asset per call,
+ * 	in the order they were deferred.
+ *
+ *	@return Returns the number of deferred assets still to be loaded
+ */
+unsigned int asset_idle();
+
+/**
+ *  @brief Loads every registered asset not loaded yet
+ *
+ * 	Images outside the asset pack are decoded concurrently, on
+ * 	parallel_workers() threads, then converted one at a time. Returns
+ * 	once every asset is loaded.
+ *
+ *	@return Returns the number of assets loaded
+ */
+unsigned int asset_preload();
+
+/**
+ *  @brief Frees every resident asset
+ *
+ * 	Meant to be called when leaving the game. Handles still acquired
+ * 	become invalid. The asset arena's high-water mark is printed.
+ */
+void asset_free_all();
+
+/**@}*/
+
+#endif /* __ASSET_H */
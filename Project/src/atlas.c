@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <string.h>
+#include "atlas.h"
+
+static Surface* atlas = NULL;					/**< Atlas' pixels */
+static AtlasRect rects[ATLAS_MAX_SPRITES];		/**< Sprites' rectangles */
+static int n_sprites = 0;						/**< Number of sprites */
+static int shelf_x = 0;							/**< Next free column of the open shelf */
+static int shelf_y = 0;							/**< Open shelf's top row */
+static int shelf_height = 0;					/**< Open shelf's height */
+
+/** Places a rectangle in the open shelf, or in a new one, -1 if full */
+static int atlas_place(const Surface* image, int x, int y, int width, int height) {
+
+	if (n_sprites == ATLAS_MAX_SPRITES || width > ATLAS_WIDTH)
+		return -1;
+
+	if (atlas == NULL && (atlas = surface_create(ATLAS_WIDTH, ATLAS_HEIGHT)) == NULL)
+		return -1;
+
+	/* the open shelf grows to its tallest sprite until it's closed */
+	if (shelf_x + width > ATLAS_WIDTH) {
+		shelf_y += shelf_height;
+		shelf_x = 0;
+		shelf_height = 0;
+	}
+	if (shelf_y + height > ATLAS_HEIGHT)
+		return -1;
+
+	AtlasRect* rect = &rects[n_sprites];
+	rect->x = shelf_x;
+	rect->y = shelf_y;
+	rect->width = width;
+	rect->height = height;
+	rect->name[0] = '\0';
+	surface_blit(atlas, image, x, y, width, height, rect->x, rect->y);
+
+	shelf_x += width;
+	if (height > shelf_height)
+		shelf_height = height;
+	return n_sprites++;
+}
+
+int atlas_add(const char* name, const Surface* image) {
+
+	return atlas_add_tiles(name, image, image->width, image->height);
+}
+
+int atlas_add_tiles(const char* name, const Surface* image, int tile_width,
+		int tile_height) {
+
+	int first = atlas_find(name);
+	if (first >= 0)
+		return first;
+
+	first = n_sprites;
+	int x, y;
+	for (y = 0; y + tile_height <= image->height; y += tile_height) {
+		for (x = 0; x + tile_width <= image->width; x += tile_width) {
+			if (atlas_place(image, x, y, tile_width, tile_height) < 0) {
+				printf("Atlas is full, couldn't add \"%s\"!\n", name);
+				n_sprites = first;
+				return -1;
+			}
+		}
+	}
+
+	if (n_sprites == first)
+		return -1;
+
+	snprintf(rects[first].name, ATLAS_NAME_MAX, "%s", name);
+	return first;
+}
+
+int atlas_find(const char* name) {
+
+	int i;
+	for (i = 0; i < n_sprites; i++)
+		if (strcmp(rects[i].name, name) == 0)
+			return i;
+
+	return -1;
+}
+
+const AtlasRect* atlas_rect(int sprite) {
+
+	return sprite >= 0 && sprite < n_sprites ? &rects[sprite] : NULL;
+}
+
+const Surface* atlas_surface() {
+
+	return atlas;
+}
+
+void atlas_free() {
+
+	surface_destroy(atlas);
+	atlas = NULL;
+	n_sprites = 0;
+	shelf_x = 0;
+	shelf_y = 0;
+	shelf_height = 0;
+}
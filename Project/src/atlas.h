@@ -0,0 +1,92 @@
+#ifndef __ATLAS_H
+#define __ATLAS_H
+
+#include "surface.h"
+
+/**
+ * @file atlas.h
+ */
+
+/**
+ *	@defgroup Atlas
+ *	@{
+ *
+ *	Texture atlas for small sprites, such as the cursor. Sprites are copied
+ *	into a single native-format surface, packed into shelves as they're
+ *	added, and drawn through a table of rectangles, so they all live in one
+ *	region of memory
+ */
+
+#define ATLAS_WIDTH			256		/**< Atlas' width */
+#define ATLAS_HEIGHT		256		/**< Atlas' height */
+#define ATLAS_MAX_SPRITES	128		/**< Maximum number of sprites */
+#define ATLAS_NAME_MAX		32		/**< Maximum length of a sprite's name */
+
+/**
+ * @brief Sprite's rectangle in the atlas
+*/
+typedef struct AtlasRect {
+	int x;						/**< Rectangle's left-upper corner x coordinate */
+	int y;						/**< Rectangle's left-upper corner y coordinate */
+	int width;					/**< Rectangle's width */
+	int height;					/**< Rectangle's height */
+	char name[ATLAS_NAME_MAX];	/**< Sprite's name, empty for a tile's followers */
+} AtlasRect;
+
+/**
+ *  @brief Adds an image to the atlas
+ *
+ * 	The image is copied, so it may be released afterwards. Adding a name
+ * 	already in the atlas returns the sprite added first.
+ *
+ *	@param name Sprite's name
+ *	@param image Sprite's image
+ *	@return Returns the sprite's id, -1 if the atlas is full
+ */
+int atlas_add(const char* name, const Surface* image);
+
+/**
+ *  @brief Adds every tile of an image to the atlas
+ *
+ * 	Tiles are read left to right, top to bottom, and given consecutive ids.
+ * 	Only the first tile is named. Adding a name already in the atlas returns
+ * 	the tiles added first.
+ *
+ *	@param name First tile's name
+ *	@param image Image made of tiles
+ *	@param tile_width Tiles' width
+ *	@param tile_height Tiles' height
+ *	@return Returns the first tile's id, -1 if the atlas is full
+ */
+int atlas_add_tiles(const char* name, const Surface* image, int tile_width,
+		int tile_height);
+
+/**
+ *  @brief Finds a sprite by its name
+ *
+ *	@param name Sprite's name
+ *	@return Returns the sprite's id, -1 if it isn't in the atlas
+ */
+int atlas_find(const char* name);
+
+/**
+ *  @brief Returns a sprite's rectangle
+ *
+ *	@param sprite Sprite's id
+ *	@return Returns pointer to the rectangle, NULL for an invalid id
+ */
+const AtlasRect* atlas_rect(int sprite);
+
+/**
+ *  @brief Returns the atlas' surface, NULL while it's empty
+ */
+const Surface* atlas_surface();
+
+/**
+ *  @brief Frees the atlas and every sprite in it
+ */
+void atlas_free();
+
+/**@}*/
+
+#endif /* __ATLAS_H */
@@ -0,0 +1,14 @@
+#include <stdint.h>
+#include <time.h>
+#include "cycles.h"
+
+uint64_t cycles_read() {
+
+#if defined(__i386__) || defined(__x86_64__)
+	uint32_t low, high;
+	__asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+	return ((uint64_t) high << 32) | low;
+#else
+	return (uint64_t) clock();
+#endif
+}
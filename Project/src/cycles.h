@@ -0,0 +1,28 @@
+#ifndef __CYCLES_H
+#define __CYCLES_H
+
+#include <stdint.h>
+
+/**
+ * @file cycles.h
+ */
+
+/**
+ *	@defgroup Cycles
+ *	@{
+ *
+ *	Processor's cycle counter, timing the game's frames and startup. Hosts
+ *	without a time stamp counter, the offline tools' on other architectures,
+ *	count the process' clock ticks instead
+ */
+
+/**
+ *  @brief Reads the processor's time stamp counter
+ *
+ *	@return Returns the number of cycles since the processor's reset
+ */
+uint64_t cycles_read();
+
+/**@}*/
+
+#endif /* __CYCLES_H */
@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "dictionary.h"
+#include "pack.h"
+
+/** Hashes a word regardless of its letters' case (32-bit FNV-1a) */
+static uint32_t dictionary_hash(const char* word, unsigned int length) {
+
+	uint32_t hash = 2166136261u;
+	unsigned int i;
+	for (i = 0; i < length; i++) {
+		hash ^= (uint32_t) toupper((unsigned char) word[i]);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/** Returns whether two words are the same, regardless of their letters' case */
+static int dictionary_equal(const char* a, const char* b, unsigned int length) {
+
+	unsigned int i;
+	for (i = 0; i < length; i++)
+		if (toupper((unsigned char) a[i]) != toupper((unsigned char) b[i]))
+			return 0;
+
+	return 1;
+}
+
+/** Returns whether a line holds a word the game can draw, letters only */
+static int dictionary_valid(const char* line, unsigned int length) {
+
+	unsigned int i;
+	for (i = 0; i < length; i++)
+		if (!isalpha((unsigned char) line[i]))
+			return 0;
+
+	return length > 0;
+}
+
+/** Returns a random number below n, from two rand() calls if it gives too few bits */
+static unsigned int dictionary_rand(unsigned int n) {
+
+	/* rand() may give as few as 15 bits, too few for large dictionaries */
+	unsigned long r = rand();
+	if (n > RAND_MAX)
+		r = r * ((unsigned long) RAND_MAX + 1) + rand();
+
+	return r % n;
+}
+
+/** Reads a whole file in a single call, NULL on failure */
+static char* dictionary_read(const char* path, size_t* size) {
+
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+
+	char* buffer = NULL;
+	long length;
+	if (fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) >= 0
+			&& fseek(file, 0, SEEK_SET) == 0) {
+		buffer = (char *) malloc(length > 0 ? length : 1);
+		if (buffer != NULL && fread(buffer, 1, length, file) != (size_t) length) {
+			free(buffer);
+			buffer = NULL;
+		}
+		*size = length;
+	}
+
+	fclose(file);
+	return buffer;
+}
+
+/** Interns the text's words, finding repeated ones through a table of word indices */
+static int dictionary_intern(Dictionary* dictionary, DictWord* words,
+		unsigned int n_lines) {
+
+	/* at most half full, so probe sequences stay short */
+	unsigned int n_slots = 16;
+	while (n_slots < 2 * n_lines)
+		n_slots *= 2;
+
+	uint32_t* slots = (uint32_t *) calloc(n_slots, sizeof(uint32_t));
+	if (slots == NULL)
+		return 1;
+
+	const char* text = dictionary->text;
+	const char* end = text + dictionary->size;
+	const char* line = text;
+	while (line < end) {
+		const char* newline = (const char *) memchr(line, '\n', end - line);
+		const char* line_end = newline != NULL ? newline : end;
+		unsigned int length = line_end - line;
+		if (length > 0 && line[length - 1] == '\r')
+			length--;
+
+		if (dictionary_valid(line, length)) {
+			/* slots hold a word's index plus one, 0 if free */
+			uint32_t slot = dictionary_hash(line, length) & (n_slots - 1);
+			while (slots[slot] != 0) {
+				const DictWord* word = &words[slots[slot] - 1];
+				if (word->length == length
+						&& dictionary_equal(text + word->offset, line, length))
+					break;
+				slot = (slot + 1) & (n_slots - 1);
+			}
+
+			if (slots[slot] == 0) {
+				words[dictionary->n_words].offset = line - text;
+				words[dictionary->n_words].length = length;
+				slots[slot] = ++dictionary->n_words;
+			}
+		}
+
+		line = line_end + 1;
+	}
+
+	free(slots);
+	return 0;
+}
+
+/** Uses a compiled dictionary in place, 1 if it's corrupt */
+static int dictionary_compiled(Dictionary* dictionary, const char* data, size_t size) {
+
+	const DictHeader* header = (const DictHeader *) data;
+	if (header->version != DICT_VERSION
+			|| header->n_words > (size - sizeof(DictHeader)) / sizeof(DictWord))
+		return 1;
+
+	size_t text_start = sizeof(DictHeader) + header->n_words * sizeof(DictWord);
+	if (header->text_size != size - text_start || header->buckets[0] != 0
+			|| header->buckets[DICT_BUCKETS] != header->n_words)
+		return 1;
+
+	unsigned int i;
+	for (i = 0; i < DICT_BUCKETS; i++)
+		if (header->buckets[i] > header->buckets[i + 1])
+			return 1;
+
+	const DictWord* words = (const DictWord *) (data + sizeof(DictHeader));
+	for (i = 0; i < header->n_words; i++)
+		if (words[i].length == 0 || words[i].offset > header->text_size
+				|| words[i].length > header->text_size - words[i].offset)
+			return 1;
+
+	dictionary->text = data + text_start;
+	dictionary->size = header->text_size;
+	dictionary->words = words;
+	dictionary->n_words = header->n_words;
+	dictionary->buckets = header->buckets;
+	return 0;
+}
+
+Dictionary* dictionary_load(const char* pack_name, const char* path, int optional) {
+
+	Dictionary* dictionary = (Dictionary *) malloc(sizeof(Dictionary));
+	if (dictionary == NULL)
+		return NULL;
+
+	/* words are used in place from the asset pack, if there's one */
+	dictionary->size = 0;
+	dictionary->buffer = NULL;
+	dictionary->arena.base = NULL;
+	dictionary->buckets = NULL;
+	dictionary->text = (const char *) pack_get(pack_name, PACK_DATA,
+			&dictionary->size);
+	if (dictionary->text == NULL) {
+		dictionary->buffer = dictionary_read(path, &dictionary->size);
+		dictionary->text = dictionary->buffer;
+	}
+
+	if (dictionary->text == NULL) {
+		if (!optional)
+			printf("\"%s\" couldn't be read!\n", path);
+		free(dictionary);
+		return NULL;
+	}
+
+	if (dictionary->size >= sizeof(DictHeader)
+			&& ((const DictHeader *) dictionary->text)->magic == DICT_MAGIC) {
+		if (dictionary_compiled(dictionary, dictionary->text, dictionary->size) != 0) {
+			printf("\"%s\" is corrupt!\n", path);
+			dictionary_destroy(dictionary);
+			return NULL;
+		}
+
+		printf("%u words read!\n", dictionary->n_words);
+		return dictionary;
+	}
+
+	/* there are at most as many words as lines */
+	unsigned int n_lines = 1;
+	const char* line = dictionary->text;
+	const char* end = dictionary->text + dictionary->size;
+	while ((line = (const char *) memchr(line, '\n', end - line)) != NULL) {
+		line++;
+		n_lines++;
+	}
+
+	DictWord* words = NULL;
+	dictionary->n_words = 0;
+	if (arena_init(&dictionary->arena, n_lines * sizeof(DictWord)) != 0
+			|| (words = (DictWord *) arena_alloc(&dictionary->arena,
+					n_lines * sizeof(DictWord))) == NULL
+			|| dictionary_intern(dictionary, words, n_lines) != 0) {
+		printf("\"%s\" doesn't fit in memory!\n", path);
+		dictionary_destroy(dictionary);
+		return NULL;
+	}
+
+	/* gives back the room of repeated words and skipped lines */
+	dictionary->words = (DictWord *) arena_realloc(&dictionary->arena, words,
+			n_lines * sizeof(DictWord), dictionary->n_words * sizeof(DictWord));
+
+	printf("%u words read!\n", dictionary->n_words);
+	return dictionary;
+}
+
+void dictionary_destroy(Dictionary* dictionary) {
+
+	if (dictionary == NULL)
+		return;
+
+	arena_destroy(&dictionary->arena);
+	free(dictionary->buffer);
+	free(dictionary);
+}
+
+const char* dictionary_word(const Dictionary* dictionary, unsigned int index,
+		unsigned int* length) {
+
+	*length = dictionary->words[index].length;
+	return dictionary->text + dictionary->words[index].offset;
+}
+
+unsigned int dictionary_random(const Dictionary* dictionary) {
+
+	return dictionary_rand(dictionary->n_words);
+}
+
+unsigned int dictionary_bucket(unsigned int length, unsigned int level) {
+
+	if (length > DICT_LENGTHS)
+		length = DICT_LENGTHS;
+
+	return (length - 1) * DICT_LEVELS + level;
+}
+
+int dictionary_draw(const Dictionary* dictionary, unsigned int length,
+		unsigned int level, unsigned int* index) {
+
+	if (dictionary->buckets == NULL) {
+		*index = dictionary_random(dictionary);
+		return 0;
+	}
+
+	unsigned int bucket = dictionary_bucket(length, level);
+	uint32_t first = dictionary->buckets[bucket];
+	uint32_t n_words = dictionary->buckets[bucket + 1] - first;
+	if (n_words == 0)
+		return 1;
+
+	*index = first + dictionary_rand(n_words);
+	return 0;
+}
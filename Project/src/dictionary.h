@@ -0,0 +1,139 @@
+#ifndef __DICTIONARY_H
+#define __DICTIONARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arena.h"
+
+/**
+ * @file dictionary.h
+ */
+
+/**
+ *	@defgroup Dictionary
+ *	@{
+ *
+ *	Game's word list, of any size. The words file is read in a single call,
+ *	or used in place from the asset pack, and its words are never copied:
+ *	each distinct word is interned once, as an offset and a length into the
+ *	file's text, in an arena sized from the file's number of lines.
+ *
+ *	A dictionary compiled by dictc is used as is instead: its words come
+ *	sorted into buckets by length and difficulty, so a word of either is
+ *	drawn in constant time
+ */
+
+#define DICT_MAGIC		0x444b4e53	/**< Compiled dictionary's magic number ("SNKD") */
+#define DICT_VERSION	1			/**< Compiled dictionary format's version */
+#define DICT_LENGTHS	16			/**< Word lengths bucketed, the last one and longer together */
+#define DICT_LEVELS		4			/**< Difficulty levels, 0 the easiest */
+#define DICT_BUCKETS	(DICT_LENGTHS * DICT_LEVELS)	/**< Number of buckets */
+
+/**
+ * @brief Dictionary's interned word
+*/
+typedef struct DictWord {
+	uint32_t offset;			/**< Word's first letter, in the dictionary's text */
+	uint32_t length;			/**< Word's number of letters */
+} DictWord;
+
+/**
+ * @brief Compiled dictionary's header
+ *
+ * Followed by the words, sorted by bucket, and then their letters, in
+ * uppercase, back to back.
+*/
+typedef struct DictHeader {
+	uint32_t magic;				/**< Must be DICT_MAGIC */
+	uint32_t version;			/**< Must be DICT_VERSION */
+	uint32_t n_words;			/**< Number of words */
+	uint32_t text_size;			/**< Size of the words' letters */
+	uint32_t buckets[DICT_BUCKETS + 1];	/**< First word of each bucket, by length then level, and the words' end */
+} DictHeader;
+
+/**
+ * @brief Game's dictionary
+*/
+typedef struct Dictionary {
+	const char* text;			/**< Words file's contents */
+	char* buffer;				/**< Contents read from the file, NULL if they're the pack's */
+	size_t size;				/**< Text's size in bytes */
+	Arena arena;				/**< Interned words' memory */
+	const DictWord* words;		/**< Distinct words, in the file's order or by bucket */
+	unsigned int n_words;		/**< Number of distinct words */
+	const uint32_t* buckets;	/**< Compiled dictionary's buckets, NULL for a words file */
+} Dictionary;
+
+/**
+ *  @brief Loads the game's dictionary
+ *
+ * 	Takes the words from the asset pack's entry, if there's one, or else
+ * 	reads the whole file at once. A compiled dictionary is recognized by
+ * 	its magic number. Otherwise words are one per line; lines with
+ * 	anything but letters are skipped, and words repeated in any case are
+ * 	kept once. A dictionary taken from the pack must be destroyed before
+ * 	the pack is closed.
+ *
+ *	@param pack_name Dictionary's entry in the asset pack
+ *	@param path Dictionary's path, without pack
+ *	@param optional Whether a missing dictionary fails quietly, as when a
+ *	fallback is tried next
+ *	@return Returns pointer to the dictionary, NULL on failure
+ */
+Dictionary* dictionary_load(const char* pack_name, const char* path, int optional);
+
+/**
+ *  @brief Dictionary destroyer
+ *
+ *	@param dictionary Dictionary to be destroyed
+ */
+void dictionary_destroy(Dictionary* dictionary);
+
+/**
+ *  @brief Accesses one of the dictionary's words
+ *
+ * 	The word's letters aren't null-terminated, and keep the file's case.
+ *
+ *	@param dictionary Game's dictionary
+ *	@param index Word's index
+ *	@param length Returns the word's number of letters
+ *	@return Returns pointer to the word's first letter
+ */
+const char* dictionary_word(const Dictionary* dictionary, unsigned int index,
+		unsigned int* length);
+
+/**
+ *  @brief Picks one of the dictionary's words at random
+ *
+ *	@param dictionary Game's dictionary, not empty
+ *	@return Returns the word's index
+ */
+unsigned int dictionary_random(const Dictionary* dictionary);
+
+/**
+ *  @brief Returns the bucket of a word's length and difficulty
+ *
+ *	@param length Word's number of letters, at least 1
+ *	@param level Word's difficulty level, less than DICT_LEVELS
+ *	@return Returns the bucket's index
+ */
+unsigned int dictionary_bucket(unsigned int length, unsigned int level);
+
+/**
+ *  @brief Picks a word of a given length and difficulty at random
+ *
+ * 	Takes constant time. Only compiled dictionaries know their words'
+ * 	lengths and difficulties, a words file gives any word instead.
+ *
+ *	@param dictionary Game's dictionary, not empty
+ *	@param length Word's number of letters, at least 1
+ *	@param level Word's difficulty level, less than DICT_LEVELS
+ *	@param index Returns the word's index
+ *	@return Returns 0 upon success and non-zero if there's no such word
+ */
+int dictionary_draw(const Dictionary* dictionary, unsigned int length,
+		unsigned int level, unsigned int* index);
+
+/**@}*/
+
+#endif /* __DICTIONARY_H */
@@ -6,13 +6,23 @@
 #include <unistd.h>
 #include <math.h>
 #include <ctype.h>
+#include <string.h>
 #include "game.h"
-#include "stbi_png.h"
+#include "asset.h"
+#include "pack.h"
+#include "dictionary.h"
+#include "profile.h"
+#include "parallel.h"
 #include "video_gr.h"
 #include "kbd.h"
 #include "timer.h"
 #include "mouse.h"
 #include "rtc.h"
+#include "surface.h"
+#include "transition.h"
+#include "governor.h"
+#include "sprite.h"
+#include "particles.h"
 
 /* irq lines for IO/devices */
 int g_hookid_timer = 0;
@@ -27,41 +37,307 @@ unsigned long g_byte;
 
 unsigned long status, outbuff_trash;
 
-/* Snake singly-linked list */
-struct Snake* first_node = NULL;
-struct Snake* last_node = NULL;
+
+/** Blends two RGB colors, alpha ranging from 0 to 256 */
+static uint32_t blend_color(uint32_t a, uint32_t b, unsigned int alpha) {
+
+	uint32_t color = 0;
+	int shift;
+	for (shift = 16; shift >= 0; shift -= 8) {
+		uint32_t ca = (a >> shift) & 0xff;
+		uint32_t cb = (b >> shift) & 0xff;
+		color |= ((ca * (256 - alpha) + cb * alpha) >> 8) << shift;
+	}
+
+	return color;
+}
+
+/** Reads a pixel of the menu, with a button's patch applied */
+static uint32_t patch_pixel(const Menu* menu, const Patch* patch, int x, int y) {
+
+	const Surface* pixels = patch->pixels;
+	if (x >= patch->x && y >= patch->y && x < patch->x + pixels->width
+			&& y < patch->y + pixels->height)
+		return surface_get_pixel(pixels, x - patch->x, y - patch->y);
+
+	return indexed_get_pixel(menu->menu, x, y);
+}
+
+/** Builds a menu button's glow, blending the menu into its hovered image */
+static SpriteSheet* build_glow_sprites(Menu* menu, const Patch* hover,
+		coord_t* button) {
+
+	int width = button[1].x - button[0].x + 1;
+	int height = button[1].y - button[0].y + 1;
+
+	SpriteSheet* sheet = create_sprite_sheet(width, height, GLOW_FRAMES, 1);
+	if (sheet == NULL)
+		return NULL;
+
+	unsigned int frame;
+	int x, y;
+	for (frame = 0; frame < GLOW_FRAMES; frame++) {
+		unsigned int alpha = (frame << 8) / (GLOW_FRAMES - 1);
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < width; x++) {
+				uint32_t idle = indexed_get_pixel(menu->menu,
+						button[0].x + x, button[0].y + y);
+				uint32_t hovered = patch_pixel(menu, hover,
+						button[0].x + x, button[0].y + y);
+				surface_put_pixel(sheet->surface, x, frame * height + y,
+						blend_color(idle, hovered, alpha));
+			}
+		}
+	}
+
+	return sheet;
+}
+
+/** Returns the row of the snake head's sprites facing a direction */
+static unsigned int head_row(unsigned long key) {
+
+	switch (key) {
+	case A_KEY:
+		return 1;
+	case S_KEY:
+		return 2;
+	case W_KEY:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
+/** Colors a pixel of the snake's head facing right, being u and v
+ * its coordinates along and across the moving direction */
+static uint32_t head_pixel(unsigned int frame, int u, int v, int side) {
+
+	int left_eye = v >= 3 && v < 7;
+	int right_eye = v >= side - 7 && v < side - 3;
+
+	if ((left_eye || right_eye) && u >= 11 && u < 15) {
+		/* eyes blink on the last frame */
+		if (frame == HEAD_FRAMES - 1)
+			return u == 13 ? BLACK : SNAKE_COLOR;
+
+		int pupil = (v == 4 || v == 5 || v == side - 6 || v == side - 5) && u >= 13;
+		return pupil ? BLACK : WHITE;
+	}
+
+	/* tongue flicks out on the first frames */
+	int tongue = frame == 1 ? 3 : (frame == 2 ? 5 : 0);
+	if (v >= side / 2 - 1 && v <= side / 2 && u >= side - tongue)
+		return RED;
+
+	return SNAKE_COLOR;
+}
+
+/** Builds the snake head's frames, one row per moving direction */
+static SpriteSheet* build_head_sprites(int side) {
+
+	SpriteSheet* sheet = create_sprite_sheet(side, side, 4 * HEAD_FRAMES,
+			HEAD_FRAMES);
+	if (sheet == NULL)
+		return NULL;
+
+	unsigned int row, frame;
+	int x, y, u, v;
+	for (row = 0; row < 4; row++) {
+		for (frame = 0; frame < HEAD_FRAMES; frame++) {
+			for (y = 0; y < side; y++) {
+				for (x = 0; x < side; x++) {
+					/* rotates the head facing right to the row's direction */
+					switch (row) {
+					case 1:
+						u = side - 1 - x;
+						v = y;
+						break;
+					case 2:
+						u = y;
+						v = x;
+						break;
+					case 3:
+						u = side - 1 - y;
+						v = x;
+						break;
+					default:
+						u = x;
+						v = y;
+						break;
+					}
+					surface_put_pixel(sheet->surface, frame * side + x,
+							row * side + y, head_pixel(frame, u, v, side));
+				}
+			}
+		}
+	}
+
+	return sheet;
+}
+
+/** Registers every image asset, in the order they're needed */
+static void register_assets() {
+
+	asset_defer(MENU_IMGPATH, ASSET_INDEXED);
+	asset_defer(CURSOR_IMGPATH, ASSET_NATIVE);
+	asset_defer_patch(MENUPLAY_IMGPATH, MENU_IMGPATH);
+	asset_defer_patch(MENUEXIT_IMGPATH, MENU_IMGPATH);
+	asset_defer(SNAKE_VICT_IMGPATH, ASSET_INDEXED);
+	asset_defer(CURSOR_VICT_IMGPATH, ASSET_INDEXED);
+	asset_defer(FONT_IMGPATH, ASSET_NATIVE);
+}
+
+/** Fits an 8-bit mode's palette to every screen's assets: the menu and its
+ * buttons, the victory screens, the font and every sprite in the atlas */
+static void adapt_palette(const Game* game) {
+
+	if (game->video_mode != VG_MODE_8BPP)
+		return;
+
+	IndexedSurface* image = asset_acquire_indexed(MENU_IMGPATH);
+	vg_palette_gather_indexed(image);
+	asset_release(image);
+	image = asset_acquire_indexed(SNAKE_VICT_IMGPATH);
+	vg_palette_gather_indexed(image);
+	asset_release(image);
+	image = asset_acquire_indexed(CURSOR_VICT_IMGPATH);
+	vg_palette_gather_indexed(image);
+	asset_release(image);
+
+	Patch* patch = asset_acquire_patch(MENUPLAY_IMGPATH, MENU_IMGPATH);
+	if (patch != NULL)
+		vg_palette_gather(patch->pixels);
+	asset_release(patch);
+	patch = asset_acquire_patch(MENUEXIT_IMGPATH, MENU_IMGPATH);
+	if (patch != NULL)
+		vg_palette_gather(patch->pixels);
+	asset_release(patch);
+
+	Surface* font = asset_acquire(FONT_IMGPATH);
+	vg_palette_gather(font);
+	asset_release(font);
+
+	/* sprites one at a time, the atlas' free room is left out */
+	const Surface* atlas = atlas_surface();
+	const AtlasRect* rect;
+	int sprite;
+	for (sprite = 0; atlas != NULL && (rect = atlas_rect(sprite)) != NULL; sprite++) {
+		Surface view = *atlas;
+		view.width = rect->width;
+		view.height = rect->height;
+		view.pixels += rect->y * atlas->pitch + rect->x * SURFACE_BYTES_PER_PIXEL;
+		vg_palette_gather(&view);
+	}
+
+	if (vg_palette_adapt() != 0)
+		printf("Couldn't adapt the palette to the assets!\n");
+}
 
 void handle_event(Game* game, game_event_t game_event) {
+
+	int startup, phase;
+	unsigned long retries;
+
 	switch (game->current_state) {
 	case INIT:
+		startup = profile_begin("handle_event(INIT)");
 		/* IO devices hookid's */
 		game->hookid_timer = 0;
 		game->hookid_kbd = 1;
 		game->hookid_mouse = 12;
+		/* open the asset pack, loose files are used without it */
+		phase = profile_begin("pack_open");
+		if (pack_open(PACK_FILEPATH) != 0)
+			printf("Asset pack not found, loading loose files!\n");
+		profile_end(phase);
+		/* read the dictionary, matches pick their words from it */
+		phase = profile_begin("dictionary_load");
+		game->dictionary = dictionary_load(WORDS_DICT_PACKNAME, WORDS_DICT_FILEPATH, 1);
+		if (game->dictionary == NULL)
+			game->dictionary = dictionary_load(WORDS_PACKNAME, WORDS_FILEPATH, 0);
+		profile_end(phase);
+		/* decode every image up front where there are threads, otherwise
+		 * those not needed right away are loaded while the menu is idle */
+		register_assets();
+		if (parallel_workers() > 1)
+			asset_preload();
 		/* initializing menu */
+		phase = profile_begin("initialize_menu");
 		game->menu = initialize_menu();
+		profile_end(phase);
 		/* initializing cursor */
+		phase = profile_begin("initialize_cursor");
 		game->cursor = initialize_cursor();
+		profile_end(phase);
 		/* subscribe timer 0 interrupts */
+		phase = profile_begin("timer_subscribe_int");
 		timer_subscribe_int(&g_hookid_timer);
+		profile_end(phase);
 		/* subscribe mouse interrupts */
+		phase = profile_begin("mouse_subscribe_int");
 		mouse_subscribe_int(&g_hookid_mouse);
-		/* enable mouse */
+		profile_end(phase);
+		/* enable mouse, counting the KBC's retries */
+		retries = kbc_retries();
+		phase = profile_begin("mouse_write_cmd(ENABLE_MOUSE)");
 		mouse_write_cmd(ENABLE_MOUSE);
+		profile_end(phase);
+		profile_count(phase, kbc_retries() - retries);
 		/* start vg 800x600 resolution */
-		vg_init(0x115);
+		phase = profile_begin("vg_init");
+		vg_init(game->video_mode);
+		profile_end(phase);
+		/* a full present of a cleared screen, to compare the modes' cost */
+		vg_clear();
+		phase = profile_begin("vg_copy");
+		vg_copy();
+		profile_end(phase);
+		/* allocate screen transitions */
+		game->transition = initialize_transition(H_RES, V_RES);
+		if (game->transition == NULL)
+			printf("Screen transitions couldn't be allocated, screens will cut!\n");
+		/* build in-game sprites */
+		animator_init(&game->animator);
+		phase = profile_begin("build sprites");
+		game->head_sprites = build_head_sprites(SNAKE_SIDE);
+		game->letter_sprites = create_sprite_sheet(LETTER_SIZE, LETTER_SIZE,
+				LETTER_FRAMES, LETTER_FRAMES);
+		profile_end(phase);
+		/* 8-bit modes spend their free palette entries on every screen */
+		phase = profile_begin("adapt_palette");
+		adapt_palette(game);
+		profile_end(phase);
+		game->head_anim = NULL;
+		game->letter_anim = NULL;
+		/* the font is compiled once its image is loaded */
+		game->font = NULL;
+		/* allocate particle effects */
+		game->particles = initialize_particles();
+		profile_end(startup);
 		/* go to menu */
 		game->current_state = MENU;
 		main_menu(game);
+		/* free game */
+		free(game);
 		break;
 	case MENU:
 		if (game_event == PLAY_BUTTON) {
+			/* pick the match's words, staying in the menu without any */
+			game->words = pick_words(game->dictionary, &game->n_words);
+			if (game->words == NULL || game->n_words == 0) {
+				printf("No words to play with, check the dictionary!\n");
+				destroy_words(game->words);
+				game->words = NULL;
+				break;
+			}
 			/* initialize snake */
 			game->snake = initialize_snake();
-			/* initializes game font */
-			game->font = initialize_font();
-			/* read words from file */
-			game->words = read_words(&game->n_words);
+			/* compiles the game font, unless the menu already did */
+			if (game->font == NULL)
+				game->font = initialize_font();
+			/* stop menu animations */
+			animator_init(&game->animator);
+			game->menu->glow = NULL;
 			/* subscribe keyboard interrupts */
 			kbd_subscribe_int(&g_hookid_kbd);
 			/* play game */
@@ -76,26 +352,49 @@ void handle_event(Game* game, game_event_t game_event) {
 			destroy_cursor(game->cursor);
 			/* destroy menu */
 			destroy_menu(game->menu);
-			/* free game */
-			free(game);
+			/* destroy screen transitions */
+			destroy_transition(game->transition);
+			/* destroy in-game sprites */
+			destroy_sprite_sheet(game->head_sprites);
+			destroy_sprite_sheet(game->letter_sprites);
+			/* destroy particle effects */
+			destroy_particles(game->particles);
+			/* destroy game font */
+			destroy_font(game->font);
+			/* free every asset */
+			asset_free_all();
+			/* destroy the dictionary, before the pack it may point into */
+			dictionary_destroy(game->dictionary);
+			atlas_free();
+			pack_close();
+			/* report the startup's phases */
+			profile_report();
+			profile_log(PROFILE_LOG_FILEPATH);
+			/* leave the game, freed once the menu returns */
+			game->current_state = LEAVE;
 			/* exit vg mode */
 			vg_exit();
 			vg_free();
-			/* leave the game */
-			game->current_state = LEAVE;
 		}
 		break;
 	case PLAY:
 		if (game_event == END_GAME) {
 			/* destroys words */
 			destroy_words(game->words);
-			/* destroys font */
-			destroy_font(game->font);
 			/* destroys snake */
 			destroy_snake(game->snake);
 			/* unsubscribe keyboard interrupts */
 			kbd_unsubscribe_int(&g_hookid_kbd);
 			g_hookid_kbd = 1;
+			/* stop in-game animations */
+			animator_init(&game->animator);
+			game->head_anim = NULL;
+			game->letter_anim = NULL;
+			/* drop particle effects */
+			if (game->particles != NULL)
+				particles_clear(game->particles);
+			/* no button is hovered until the cursor moves */
+			game->menu->hover = NULL;
 			/* return to menu */
 			game->current_state = MENU;
 		}
@@ -107,45 +406,27 @@ void handle_event(Game* game, game_event_t game_event) {
 
 Menu* initialize_menu() {
 
-	Menu* menu = (Menu *) malloc(sizeof(Menu));
+	/* every member starts NULL, so a partial menu can be destroyed */
+	Menu* menu = (Menu *) calloc(1, sizeof(Menu));
 	if (menu == NULL)
 		return NULL;
 
-	/* loading menu png images */
-	menu->menu = stbi_png_load(&menu->width, &menu->height, MENU_IMGPATH);
+	/* loading menu images */
+	menu->menu = asset_acquire_indexed(MENU_IMGPATH);
 	if (menu->menu == NULL) {
 		printf("Menu's \"menu\" png image not found!\n");
-		return NULL;
-	}
-	menu->menu_play = stbi_png_load(&menu->width, &menu->height,
-			MENUPLAY_IMGPATH);
-	if (menu->menu_play == NULL) {
-		printf("Menu's \"menu_play\" png image not found!\n");
-		return NULL;
-	}
-	menu->menu_exit = stbi_png_load(&menu->width, &menu->height,
-			MENUEXIT_IMGPATH);
-	if (menu->menu_exit == NULL) {
-		printf("Menu's \"menu_exit\" png image not found!\n");
-		return NULL;
-	}
-	menu->snake_victory = stbi_png_load(&menu->width, &menu->height,
-			SNAKE_VICT_IMGPATH);
-	if (menu->snake_victory == NULL) {
-		printf("Snake's victory png image not found!\n");
-		return NULL;
-	}
-	menu->cursor_victory = stbi_png_load(&menu->width, &menu->height,
-			CURSOR_VICT_IMGPATH);
-	if (menu->cursor_victory == NULL) {
-		printf("Cursor's victory png image not found!\n");
+		destroy_menu(menu);
 		return NULL;
 	}
 
-	menu->current_background = menu->menu;
+	menu->hover = NULL;
 
-	menu->play_button = (coord_t *) malloc(sizeof(coord_t));
-	menu->exit_button = (coord_t *) malloc(sizeof(coord_t));
+	menu->play_button = (coord_t *) malloc(2 * sizeof(coord_t));
+	menu->exit_button = (coord_t *) malloc(2 * sizeof(coord_t));
+	if (menu->play_button == NULL || menu->exit_button == NULL) {
+		destroy_menu(menu);
+		return NULL;
+	}
 
 	/* -- PLAY button -- */
 	/* left corner coordinates */
@@ -163,19 +444,91 @@ Menu* initialize_menu() {
 	(menu->exit_button[1]).x = 450;
 	(menu->exit_button[1]).y = 350;
 
+	/* buttons' glow animations are built when first hovered */
+	menu->glow = NULL;
+
 	return menu;
 }
 
 void destroy_menu(Menu* menu) {
 
-	stbi_free(menu->menu);
-	stbi_free(menu->menu_play);
-	stbi_free(menu->menu_exit);
-	stbi_free(menu->snake_victory);
-	stbi_free(menu->cursor_victory);
+	asset_release(menu->menu);
+	asset_release(menu->menu_play);
+	asset_release(menu->menu_exit);
+	destroy_sprite_sheet(menu->play_glow);
+	destroy_sprite_sheet(menu->exit_glow);
+	free(menu->play_button);
+	free(menu->exit_button);
 	free(menu);
 }
 
+/** Draws the menu's image, with the hovered button's patch applied */
+static void print_background(const Menu* menu) {
+
+	vg_indexed(menu->menu, 0, 0);
+
+	const Patch* hover = menu->hover;
+	if (hover != NULL)
+		surface_blit(vg_back_buffer(), hover->pixels, 0, 0, hover->pixels->width,
+				hover->pixels->height, hover->x, hover->y);
+}
+
+/** Reverts the previous button's patch and applies the hovered one's,
+ * presenting only the areas they cover */
+static void print_hover(Game* game, const Patch* previous) {
+
+	Menu* menu = game->menu;
+	Surface* screen = vg_back_buffer();
+	const Patch* hover = menu->hover;
+
+	if (previous != NULL)
+		indexed_blit(screen, menu->menu, previous->x, previous->y,
+				previous->pixels->width, previous->pixels->height, previous->x,
+				previous->y);
+	if (hover != NULL)
+		surface_blit(screen, hover->pixels, 0, 0, hover->pixels->width,
+				hover->pixels->height, hover->x, hover->y);
+
+	animator_redraw(&game->animator);
+	print_cursor(game->cursor);
+
+	if (previous != NULL)
+		vg_copy_rect(previous->x, previous->y, previous->pixels->width,
+				previous->pixels->height);
+	if (hover != NULL)
+		vg_copy_rect(hover->x, hover->y, hover->pixels->width,
+				hover->pixels->height);
+}
+
+/** Starts the glow of the button being hovered, stopping the previous one */
+static void menu_glow(Game* game) {
+
+	Menu* menu = game->menu;
+	SpriteSheet* sheet = NULL;
+	coord_t* button = NULL;
+
+	animation_stop(&game->animator, menu->glow);
+	menu->glow = NULL;
+
+	if (menu->hover != NULL && menu->hover == menu->menu_play) {
+		if (menu->play_glow == NULL)
+			menu->play_glow = build_glow_sprites(menu, menu->menu_play,
+					menu->play_button);
+		sheet = menu->play_glow;
+		button = menu->play_button;
+	} else if (menu->hover != NULL && menu->hover == menu->menu_exit) {
+		if (menu->exit_glow == NULL)
+			menu->exit_glow = build_glow_sprites(menu, menu->menu_exit,
+					menu->exit_button);
+		sheet = menu->exit_glow;
+		button = menu->exit_button;
+	}
+
+	if (sheet != NULL)
+		menu->glow = animation_play(&game->animator, sheet, 0, GLOW_FRAMES,
+				ANIM_TICKS, ANIM_PINGPONG, button[0].x, button[0].y);
+}
+
 void menu_handling(Game* game) {
 
 	int playBoxX = (game->menu->play_button[0]).x;
@@ -185,33 +538,54 @@ void menu_handling(Game* game) {
 	int playBoxFinalY = (game->menu->play_button[1]).y;
 	int exitBoxFinalY = (game->menu->exit_button[1]).y;
 
+	Patch* hover = NULL;
+	game_event_t event = NO_EVENT;
+
 	if ((game->cursor->coord).x >= playBoxX
 			&& (game->cursor->coord).x <= playBoxFinalX) {
 		if ((game->cursor->coord).y >= playBoxY
 				&& (game->cursor->coord).y <= playBoxFinalY) {
 
-			game->menu->current_background = game->menu->menu_play;
+			/* loaded now, unless the menu was idle long enough */
+			if (game->menu->menu_play == NULL)
+				game->menu->menu_play = asset_acquire_patch(MENUPLAY_IMGPATH,
+						MENU_IMGPATH);
+			hover = game->menu->menu_play;
 
 			/* if option was clicked */
 			if (g_packet[0] & LB) {
 				/* play button selected */
-				handle_event(game, PLAY_BUTTON);
+				event = PLAY_BUTTON;
 			}
 
 		} else if ((game->cursor->coord).y >= exitBoxY
 				&& (game->cursor->coord).y <= exitBoxFinalY) {
 
-			game->menu->current_background = game->menu->menu_exit;
+			/* loaded now, unless the menu was idle long enough */
+			if (game->menu->menu_exit == NULL)
+				game->menu->menu_exit = asset_acquire_patch(MENUEXIT_IMGPATH,
+						MENU_IMGPATH);
+			hover = game->menu->menu_exit;
 
 			/* if option was clicked */
 			if (g_packet[0] & LB) {
 				/* exit button selected */
-				handle_event(game, EXIT_BUTTON);
+				event = EXIT_BUTTON;
 			}
-		} else
-			game->menu->current_background = game->menu->menu;
-	} else
-		game->menu->current_background = game->menu->menu;
+		}
+	}
+
+	/* hovering a new button changes its glow */
+	if (hover != game->menu->hover) {
+		Patch* previous = game->menu->hover;
+		game->menu->hover = hover;
+		menu_glow(game);
+		if (event == NO_EVENT)
+			print_hover(game, previous);
+	}
+
+	if (event != NO_EVENT)
+		handle_event(game, event);
 }
 
 Cursor* initialize_cursor() {
@@ -224,11 +598,19 @@ Cursor* initialize_cursor() {
 	(cursor->coord).x = 395;
 	(cursor->coord).y = 270;
 
-	/* loading png's cursor image */
-	cursor->image = stbi_png_load(&cursor->width, &cursor->height,
-			CURSOR_IMGPATH);
-	if (cursor->image == NULL) {
+	/* loading cursor's image into the atlas */
+	Surface* image = asset_acquire(CURSOR_IMGPATH);
+	if (image == NULL) {
 		printf("Cursor's png image not found!\n");
+		free(cursor);
+		return NULL;
+	}
+	cursor->sprite = atlas_add("cursor", image);
+	cursor->width = image->width;
+	cursor->height = image->height;
+	asset_release(image);
+	if (cursor->sprite < 0) {
+		free(cursor);
 		return NULL;
 	}
 
@@ -237,7 +619,6 @@ Cursor* initialize_cursor() {
 
 void destroy_cursor(Cursor* cursor) {
 
-	stbi_free(cursor->image);
 	free(cursor);
 }
 
@@ -254,32 +635,61 @@ void clean_cursor(Game* game, Word word, int letter_index) {
 	}
 
 	spawn_letters(game, word, letter_index, 0);
+}
 
-	vg_copy();
+void print_cursor(Cursor* cursor) {
+
+	vg_sprite(cursor->sprite, (cursor->coord).x, (cursor->coord).y);
 }
 
-void print_cursor(Cursor* cursor, Menu* menu) {
+void print_menu(Game* game) {
 
-	/* prints cursor over initial menu png to the screen */
-	if (menu != NULL)
-		vg_png(menu->current_background, menu->width, menu->height, 0, 0);
+	Menu* menu = game->menu;
 
-	size_t x, y;
-	for (y = 0; y < cursor->height; y++) {
-		for (x = 0; x < cursor->width; x++) {
-			uint32_t rgb[3];
-			size_t c;
-			for (c = 0; c < 3; c++)
-				rgb[c] = cursor->image[(x + y * cursor->width) * 3 + c];
-			int32_t color = ((rgb[0] << 16) & RED) | ((rgb[1] << 8) & GREEN)
-							| (rgb[2] & BLUE);
-			draw_pixel((cursor->coord).x + x, (cursor->coord).y + y, color);
-		}
-	}
+	/* prints cursor over the menu's current png to the screen */
+	print_background(menu);
+	animator_redraw(&game->animator);
+	print_cursor(game->cursor);
 
 	vg_copy();
 }
 
+/** Redraws the menu's image over a rectangle, with the hovered button's patch */
+static void restore_menu(const Menu* menu, int x, int y, int width, int height) {
+
+	Surface* screen = vg_back_buffer();
+	indexed_blit(screen, menu->menu, x, y, width, height, x, y);
+
+	const Patch* hover = menu->hover;
+	if (hover == NULL)
+		return;
+
+	/* only the part of the patch inside the rectangle */
+	int left = x > hover->x ? x : hover->x;
+	int top = y > hover->y ? y : hover->y;
+	int right = x + width < hover->x + hover->pixels->width ?
+			x + width : hover->x + hover->pixels->width;
+	int bottom = y + height < hover->y + hover->pixels->height ?
+			y + height : hover->y + hover->pixels->height;
+	if (left < right && top < bottom)
+		surface_blit(screen, hover->pixels, left - hover->x, top - hover->y,
+				right - left, bottom - top, left, top);
+}
+
+void print_menu_cursor(Game* game, coord_t from) {
+
+	Cursor* cursor = game->cursor;
+
+	/* the menu comes back where the cursor was, glow included */
+	restore_menu(game->menu, from.x, from.y, cursor->width, cursor->height);
+	animator_redraw(&game->animator);
+	print_cursor(cursor);
+
+	vg_copy_rect(from.x, from.y, cursor->width, cursor->height);
+	vg_copy_rect((cursor->coord).x, (cursor->coord).y, cursor->width,
+			cursor->height);
+}
+
 void update_cursor(Cursor* cursor, int in_menu) {
 
 	signed char delta_x = g_packet[1];
@@ -323,38 +733,89 @@ void update_cursor(Cursor* cursor, int in_menu) {
 	}
 }
 
-int test_collision_cursor(Cursor* cursor, Word word, int letter_index) {
+/** Returns the slot of the cell some coordinates fall on, NULL off the screen */
+static uint16_t* letter_cell(LetterIndex* letters, int x, int y) {
+
+	if (x < 0 || y < 0 || x >= LETTER_COLUMNS * LETTER_CELL
+			|| y >= LETTER_ROWS * LETTER_CELL)
+		return NULL;
+
+	return &letters->slots[y / LETTER_CELL][x / LETTER_CELL];
+}
+
+void index_letters(LetterIndex* letters, const coord_t* coords, unsigned int n_letters) {
 
-	/* test collision with letters on the screen */
-	size_t i;
-	for (i = letter_index; i < word.n_letters_mouse; i++) {
+	memset(letters->slots, 0, sizeof(letters->slots));
 
-		int distance_x = word.coord_mouse[i].x - cursor->coord.x;
-		int distance_y = word.coord_mouse[i].y - cursor->coord.y;
+	/* the first letter on a cell is the one hit, as when they were scanned */
+	unsigned int i;
+	for (i = 0; i < n_letters; i++) {
+		uint16_t* cell = letter_cell(letters, coords[i].x, coords[i].y);
+		if (cell != NULL && *cell == 0)
+			*cell = i + 1;
+	}
+}
 
-		/* if blocks collided horizontally or vertically */
-		if (abs(distance_y) < 16 && abs(distance_x) < 16) {
+/** Resolves a hit on a word's letter, swapping it with an equal letter due first */
+static int hit_letter(Word word, coord_t* coords, LetterIndex* letters,
+		unsigned int i, unsigned int letter_index) {
 
-			/* if letter eaten is in the correct order */
-			if (i != letter_index) {
+	/* if letter eaten is in the correct order */
+	if (i == letter_index)
+		return 2;
 
-				/* if eaten letter has more than 2 appearances on the word */
-				if (word.letters[i] == word.letters[letter_index]) {
-					coord_t temp = word.coord_mouse[i];
-					word.coord_mouse[i] = word.coord_mouse[letter_index];
-					word.coord_mouse[letter_index] = temp;
+	/* if eaten letter has more than 2 appearances on the word */
+	if (word.letters[i] != word.letters[letter_index])
+		return 1;
 
-					return 2;
-				}
+	coord_t temp = coords[i];
+	coords[i] = coords[letter_index];
+	coords[letter_index] = temp;
 
-				return 1;
-			}
+	uint16_t* cell = letter_cell(letters, coords[i].x, coords[i].y);
+	if (cell != NULL)
+		*cell = i + 1;
+	cell = letter_cell(letters, coords[letter_index].x, coords[letter_index].y);
+	if (cell != NULL)
+		*cell = letter_index + 1;
+
+	return 2;
+}
 
-			return 2;
+int test_collision_cursor(Cursor* cursor, Word word, LetterIndex* letters,
+		int letter_index) {
+
+	/* letters in reach are on the cells around the cursor */
+	int min_x = cursor->coord.x - (LETTER_REACH - 1);
+	int min_y = cursor->coord.y - (LETTER_REACH - 1);
+	int max_x = cursor->coord.x + (LETTER_REACH - 1);
+	int max_y = cursor->coord.y + (LETTER_REACH - 1);
+	unsigned int hit = word.n_letters_mouse;
+	int x, y;
+
+	if (min_x < 0)
+		min_x = 0;
+	if (min_y < 0)
+		min_y = 0;
+
+	/* the first letter in reach is the one hit, as when they were scanned */
+	for (y = min_y - min_y % LETTER_CELL; y <= max_y; y += LETTER_CELL) {
+		for (x = min_x - min_x % LETTER_CELL; x <= max_x; x += LETTER_CELL) {
+			uint16_t* cell = letter_cell(letters, x, y);
+			if (cell == NULL || *cell <= letter_index || *cell - 1u >= hit)
+				continue;
+
+			unsigned int i = *cell - 1;
+			if (abs(word.coord_mouse[i].x - cursor->coord.x) < LETTER_REACH
+					&& abs(word.coord_mouse[i].y - cursor->coord.y) < LETTER_REACH)
+				hit = i;
 		}
 	}
 
-	return 0;
+	if (hit == word.n_letters_mouse)
+		return 0;
+
+	return hit_letter(word, word.coord_mouse, letters, hit, letter_index);
 }
 
 Font* initialize_font() {
@@ -363,9 +824,19 @@ Font* initialize_font() {
 	if (font == NULL)
 		return NULL;
 
-	font->font_img = stbi_png_load(&font->width, &font->height, FONT_IMGPATH);
-	if (font->font_img == NULL) {
+	Surface* image = asset_acquire(FONT_IMGPATH);
+	if (image == NULL) {
 		printf("Font's png image not found!\n");
+		free(font);
+		return NULL;
+	}
+
+	/* the glyphs are two-tone, 1 bit per pixel is enough */
+	font->glyphs = glyph_compile(image);
+	asset_release(image);
+
+	if (font->glyphs == NULL) {
+		free(font);
 		return NULL;
 	}
 
@@ -374,165 +845,168 @@ Font* initialize_font() {
 
 void destroy_font(Font* font) {
 
-	stbi_free(font->font_img);
+	if (font != NULL)
+		glyph_destroy(font->glyphs);
 	free(font);
 }
 
-Word* read_words(size_t* n_words) {
+/** Returns a letter's glyph mask */
+static const GlyphMask* font_glyph(const Font* font, char letter) {
 
-	/* maximum number of words is 20 */
-	struct Word* words = (struct Word *) malloc(20 * sizeof(struct Word));
-	if (words == NULL)
-		return NULL;
+	return glyph_mask(font->glyphs, letter - '0');
+}
 
-	*n_words = 0;
-	char line[100];
-
-	FILE* words_file = NULL;
-	words_file = fopen(WORDS_FILEPATH, "r");
-
-	if (words_file != NULL) {
-		printf("File successfully read!\n");
-
-		/* read each line of the file */
-		while (fgets(line, 100, words_file) != NULL) {
-
-			/* ignoring \n chars */
-			if (line[strlen(line) - 1] == '\n')
-				line[strlen(line) - 1] = '\0';
-
-			/* allocating mem space to store letters and its coordinates */
-			words[*n_words].letters = (char *) malloc(sizeof(line));
-			words[*n_words].coord_kbd = (coord_t *) malloc(
-					strlen(line) * sizeof(coord_t));
-			words[*n_words].coord_mouse = (coord_t *) malloc(
-					(strlen(line) + 20) * sizeof(coord_t));
-
-			int x, y, kbdUsedCoord, mouseUsedCoord;
-			size_t i;
-			for (i = 0; i < strlen(line); i++) {
-				words[*n_words].letters[i] = toupper(line[i]);
-
-				/* generating coordinates for the new letter,
-				 * considering not to obtain occupied positions */
-				do {
-					kbdUsedCoord = 0;
-
-					do {
-						x = (rand() % 469) + 6;
-					} while (x % 20 != 0);
-
-					do {
-						y = (rand() % 574) + 6;
-					} while (y % 20 != 0);
-
-					size_t j;
-					for (j = 0; j < i; j++) {
-
-						int equal_x, equal_y, distance_x, distance_y;
-
-						/* if coordinates coincide with those of other letter */
-						equal_x = words[*n_words].coord_kbd[j].x == x;
-						equal_y = words[*n_words].coord_kbd[j].y == y;
-
-						/* verifying the distance of the spawned letter
-						 * to the snake when in between levels */
-						if (*n_words > 0) {
-							distance_x =
-									abs(
-											(words[*n_words - 1].coord_kbd[words[*n_words
-																				 - 1].n_letters_kbd - 1].x)
-																				 - x);
-							distance_y =
-									abs(
-											(words[*n_words - 1].coord_kbd[words[*n_words
-																				 - 1].n_letters_kbd - 1].y)
-																				 - y);
-						} else {
-							distance_x = abs((last_node->coord).x - x);
-							distance_y = abs((last_node->coord).y - y);
-						}
+/** Picks distinct cells for a word's letters, between two columns, with a partial
+ * Fisher-Yates shuffle of the free cells, 1 if there aren't enough of them */
+static int place_letters(coord_t* coords, unsigned int n_letters, int min_x, int max_x,
+		const coord_t* avoid, Snake* snake) {
+
+	coord_t cells[LETTER_COLUMNS * LETTER_ROWS];
+	unsigned int n_cells = 0, i;
+	coord_t cell;
+
+	/* the free cells: away from the snake's head on both axes, off its body */
+	for (cell.y = LETTER_CELL; cell.y < V_RES - LETTER_CELL; cell.y += LETTER_CELL) {
+		for (cell.x = (min_x + LETTER_CELL - 1) / LETTER_CELL * LETTER_CELL;
+				cell.x < max_x; cell.x += LETTER_CELL) {
+			if (avoid != NULL && (abs(avoid->x - cell.x) < SPAWN_DISTANCE
+					|| abs(avoid->y - cell.y) < SPAWN_DISTANCE))
+				continue;
+			if (snake != NULL && snake_occupies(snake, cell))
+				continue;
+			cells[n_cells++] = cell;
+		}
+	}
 
-						/* if coordinate is used or distance between the snake
-						 * and the spawned letter is inferior to 50, being too close
-						 * and immediately colliding with the snake */
-						if ((equal_x && equal_y) || (distance_x < 50)
-								|| (distance_y < 50)) {
-							kbdUsedCoord = 1;
-						}
-					}
-				} while (kbdUsedCoord);
+	if (n_letters > n_cells)
+		return 1;
 
-				(words[*n_words].coord_kbd[i]).x = x;
-				(words[*n_words].coord_kbd[i]).y = y;
-				words[*n_words].n_letters_kbd = strlen(line);
+	/* each letter takes a random cell among those not taken yet */
+	for (i = 0; i < n_letters; i++) {
+		unsigned int j = i + rand() % (n_cells - i);
+		coords[i] = cells[j];
+		cells[j] = cells[i];
+	}
 
-				do {
-					mouseUsedCoord = 0;
+	return 0;
+}
 
-					do {
-						x = (rand() % 295) + 500;
-					} while (x % 20 != 0);
+/** Draws a word of a length and difficulty level, else of the nearest length
+ * with words of that level, else any word */
+static unsigned int draw_word(const Dictionary* dictionary, unsigned int length,
+		unsigned int level) {
+
+	unsigned int index, distance;
+	for (distance = 0; distance < DICT_LENGTHS; distance++) {
+		if (dictionary_draw(dictionary, length + distance, level, &index) == 0)
+			return index;
+		if (distance > 0 && distance < length
+				&& dictionary_draw(dictionary, length - distance, level, &index) == 0)
+			return index;
+	}
 
-					do {
-						y = (rand() % 574) + 6;
-					} while (y % 20 != 0);
+	return dictionary_random(dictionary);
+}
 
-					size_t j;
-					for (j = 0; j < i; j++) {
-						if (words[*n_words].coord_mouse[j].x == x
-								&& words[*n_words].coord_mouse[j].y == y) {
-							mouseUsedCoord = 1;
-						}
-					}
-				} while (mouseUsedCoord);
+void place_word(Word* word, Snake* snake) {
 
-				(words[*n_words].coord_mouse[i]).x = x;
-				(words[*n_words].coord_mouse[i]).y = y;
-			}
+	/* letters keep clear of the snake's head, and off its body, as they are now */
+	coord_t head = snake_head(snake)->coord;
+	if (place_letters(word->coord_kbd, word->n_letters_kbd, LETTER_CELL,
+			MIDDLE_BORDER - LETTER_CELL, &head, snake) == 0)
+		return;
 
-			/* generating coordinates for the deceiving letters,
-			 * considering not to obtain occupied positions */
-			size_t k;
-			for (k = strlen(line); k < strlen(line) + 20; k++) {
-				words[*n_words].letters[k] = ('A' + (rand() % 26));
+	/* a long snake may leave too few cells away from its head, or at all */
+	if (place_letters(word->coord_kbd, word->n_letters_kbd, LETTER_CELL,
+			MIDDLE_BORDER - LETTER_CELL, NULL, snake) == 0)
+		return;
 
-				do {
-					mouseUsedCoord = 0;
+	place_letters(word->coord_kbd, word->n_letters_kbd, LETTER_CELL,
+			MIDDLE_BORDER - LETTER_CELL, NULL, NULL);
+}
 
-					do {
-						x = (rand() % 295) + 500;
-					} while (x % 20 != 0);
+Word* pick_words(const Dictionary* dictionary, unsigned int* n_words) {
 
-					do {
-						y = (rand() % 574) + 6;
-					} while (y % 20 != 0);
+	*n_words = 0;
+	if (dictionary == NULL || dictionary->n_words == 0)
+		return NULL;
 
-					size_t p;
-					for (p = 0; p < k; p++) {
-						if (words[*n_words].coord_mouse[p].x == x
-								&& words[*n_words].coord_mouse[p].y == y) {
-							mouseUsedCoord = 1;
-						}
-					}
-				} while (mouseUsedCoord);
+	/* a small dictionary is played whole, in order, a large one by distinct
+	 * words drawn at random, longer and harder as the match goes on */
+	unsigned int picks[MATCH_WORDS], n_picks = 0, tries = 0, i, j, length;
+	if (dictionary->n_words <= MATCH_WORDS) {
+		for (n_picks = 0; n_picks < dictionary->n_words; n_picks++)
+			picks[n_picks] = n_picks;
+	} else {
+		while (n_picks < MATCH_WORDS) {
+			unsigned int pick = dictionary_random(dictionary);
+			if (tries < MATCH_TRIES)
+				pick = draw_word(dictionary, MATCH_MIN_LENGTH + n_picks
+						* (MATCH_MAX_LENGTH - MATCH_MIN_LENGTH + 1) / MATCH_WORDS,
+						n_picks * DICT_LEVELS / MATCH_WORDS);
+
+			for (j = 0; j < n_picks && picks[j] != pick; j++)
+				;
+			if (j == n_picks) {
+				picks[n_picks++] = pick;
+				tries = 0;
+			} else
+				tries++;
+		}
+	}
 
-				(words[*n_words].coord_mouse[k]).x = x;
-				(words[*n_words].coord_mouse[k]).y = y;
-			}
+	/* the words, their letters and coordinates share a single allocation */
+	size_t n_letters = 0;
+	for (i = 0; i < n_picks; i++) {
+		dictionary_word(dictionary, picks[i], &length);
+		n_letters += length;
+	}
+	size_t n_coords = 2 * n_letters + n_picks * WORD_DECOYS;
+	size_t n_chars = n_letters + n_picks * WORD_DECOYS;
 
-			/* the mouse has 20 more letters than the keyboard */
-			words[*n_words].n_letters_mouse = strlen(line) + 20;
+	Word* words = (Word *) malloc(n_picks * sizeof(Word) + n_coords * sizeof(coord_t)
+			+ n_chars);
+	if (words == NULL)
+		return NULL;
 
-			(*n_words)++;
+	coord_t* coords = (coord_t *) (words + n_picks);
+	char* chars = (char *) (coords + n_coords);
+
+	for (i = 0; i < n_picks; i++) {
+		const char* letters = dictionary_word(dictionary, picks[i], &length);
+		Word* word = &words[*n_words];
+		word->letters = chars;
+		word->coord_kbd = coords;
+		word->coord_mouse = coords + length;
+
+		for (j = 0; j < length; j++)
+			word->letters[j] = toupper((unsigned char) letters[j]);
+
+		/* deceiving letters for the mouse */
+		for (j = length; j < length + WORD_DECOYS; j++)
+			word->letters[j] = ('A' + (rand() % 26));
+
+		/* the snake's letters are placed again when the word becomes
+		 * active, around the snake as it is then; here they must just fit */
+		if (place_letters(word->coord_kbd, length, LETTER_CELL,
+				MIDDLE_BORDER - LETTER_CELL, NULL, NULL) != 0
+				|| place_letters(word->coord_mouse, length + WORD_DECOYS,
+						MIDDLE_BORDER + BORDER_SIZE, H_RES - BORDER_SIZE, NULL,
+						NULL) != 0) {
+			printf("Word \"%.*s\" doesn't fit on the screen!\n", (int) length, letters);
+			continue;
 		}
 
-		fclose(words_file);
-		return words;
+		/* the mouse has more letters than the keyboard */
+		word->n_letters_kbd = length;
+		word->n_letters_mouse = length + WORD_DECOYS;
+
+		chars += length + WORD_DECOYS;
+		coords += 2 * length + WORD_DECOYS;
+		(*n_words)++;
 	}
 
-	printf("File could not be read!\n");
-	return NULL;
+	return words;
 }
 
 void destroy_words(Word* words) {
@@ -542,236 +1016,334 @@ void destroy_words(Word* words) {
 
 void spawn_letters(Game* game, Word word, unsigned int letter_index, int kbd) {
 
+	const GlyphSet* glyphs = game->font->glyphs;
 	size_t j;
 	if (kbd) {
 		for (j = letter_index; j < word.n_letters_kbd; j++) {
-			vg_tile(game->font->font_img, word.letters[j], game->font->width,
-					game->font->height, word.coord_kbd[j].x,
-					word.coord_kbd[j].y);
+			vg_tile(font_glyph(game->font, word.letters[j]), glyphs->ink, glyphs->paper,
+					word.coord_kbd[j].x, word.coord_kbd[j].y);
 		}
 	} else {
 		for (j = letter_index; j < word.n_letters_mouse; j++) {
-			vg_tile(game->font->font_img, word.letters[j], game->font->width,
-					game->font->height, word.coord_mouse[j].x,
-					word.coord_mouse[j].y);
+			vg_tile(font_glyph(game->font, word.letters[j]), glyphs->ink, glyphs->paper,
+					word.coord_mouse[j].x, word.coord_mouse[j].y);
 		}
 	}
 }
 
-Snake* new_node(Snake info) {
+SnakeBlock* snake_block(Snake* snake, unsigned int i) {
 
-	Snake* new_node = (Snake *) malloc(sizeof(Snake));
-	if (new_node == NULL)
-		return NULL;
-
-	*new_node = info;
-	new_node->next = NULL;
-	return new_node;
+	return &snake->blocks[(snake->tail + i) % SNAKE_CAPACITY];
 }
 
-void push_front(Snake* node) {
+SnakeBlock* snake_head(Snake* snake) {
 
-	if (first_node == last_node && first_node == NULL) {
-		first_node = node;
-		last_node = node;
-		first_node->next = NULL;
-		last_node->next = NULL;
-	} else {
-		Snake* temp = first_node;
-		first_node = node;
-		first_node->next = temp;
-	}
+	return snake_block(snake, snake->length - 1);
 }
 
-void push_back(Snake* node) {
-
-	if (first_node == last_node && last_node == NULL) {
-		first_node = node;
-		last_node = node;
-		first_node->next = NULL;
-		last_node->next = NULL;
-	} else {
-		Snake* tmp = first_node;
-		while (tmp->next != NULL) {
-			tmp = tmp->next;
-		}
+SnakeBlock* snake_tail(Snake* snake) {
 
-		tmp->next = node;
-		tmp->next->next = NULL;
-		last_node = node;
-	}
+	return snake_block(snake, 0);
 }
 
-Snake* pop_front() {
+/** Returns the cell at some coordinates, NULL outside the snake's part of the screen */
+static uint8_t* snake_cell(Snake* snake, coord_t coord) {
 
-	Snake* info = NULL;
-	if (first_node != NULL) {
-		info = first_node;
-		first_node = first_node->next;
-	}
+	if (coord.x < 0 || coord.y < 0)
+		return NULL;
 
-	/* to never dereference a NULL pointer */
-	if (first_node == NULL) {
-		first_node = info;
-	}
+	int column = coord.x / snake->side, row = coord.y / snake->side;
+	if (column >= SNAKE_COLUMNS || row >= SNAKE_ROWS)
+		return NULL;
 
-	return info;
+	return &snake->cells[row][column];
 }
 
-Snake* pop_back() {
+/** Counts a block entering (1) or leaving (-1) its cell */
+static void snake_mark(Snake* snake, coord_t coord, int blocks) {
 
-	Snake* info = NULL;
-	if (first_node->next == NULL) {
-		info = first_node;
-		first_node = NULL;
-		last_node = NULL;
-	} else {
-		Snake* tmp = first_node;
-		while (tmp->next->next != NULL) {
-			tmp = tmp->next;
-		}
-		info = tmp->next;
-		tmp->next = NULL;
-		last_node = tmp;
-	}
+	uint8_t* cell = snake_cell(snake, coord);
+	if (cell != NULL)
+		*cell += blocks;
+}
 
-	/* to never dereference a NULL pointer */
-	if (last_node == NULL) {
-		last_node = info;
-	}
+unsigned int snake_occupies(Snake* snake, coord_t coord) {
 
-	return info;
+	uint8_t* cell = snake_cell(snake, coord);
+	return cell != NULL ? *cell : 0;
 }
 
 void spawn_block(Snake* snake) {
 
-	int sucess = 0;
-	Snake* new_block = new_node(*first_node);
+	if (snake->length == SNAKE_CAPACITY)
+		return;
 
-	switch (first_node->key) {
+	SnakeBlock block = *snake_tail(snake);
+
+	switch (block.key) {
 	case W_KEY:
-		(new_block->coord).y += snake->side;
-		sucess = 1;
+		(block.coord).y += snake->side;
 		break;
 	case A_KEY:
-		(new_block->coord).x += snake->side;
-		sucess = 1;
+		(block.coord).x += snake->side;
 		break;
 	case S_KEY:
-		(new_block->coord).y -= snake->side;
-		sucess = 1;
+		(block.coord).y -= snake->side;
 		break;
 	case D_KEY:
-		(new_block->coord).x -= snake->side;
-		sucess = 1;
+		(block.coord).x -= snake->side;
 		break;
 	default:
 		printf("Wrong direction error!\n");
+		return;
 	}
 
-	if (sucess)
-		push_front(new_block);
-	else
-		free(new_block);
+	/* the new block goes right before the tail */
+	snake->tail = (snake->tail + SNAKE_CAPACITY - 1) % SNAKE_CAPACITY;
+	snake->length++;
+	*snake_tail(snake) = block;
+	snake_mark(snake, block.coord, 1);
 }
 
 Snake* initialize_snake() {
 
-	Snake head;
-	head.side = 20;
-	(head.coord).x = 0;
-	(head.coord).y = 300;
-	head.key = D_KEY;
-	head.color = SNAKE_COLOR;
-	head.next = NULL;
-
-	Snake* node = new_node(head);
-	push_front(node);
-	return node;
+	Snake* snake = (Snake *) malloc(sizeof(Snake));
+	if (snake == NULL)
+		return NULL;
+
+	snake->side = SNAKE_SIDE;
+	snake->color = SNAKE_COLOR;
+	snake->tail = 0;
+	snake->length = 1;
+	(snake->blocks[0].coord).x = 0;
+	(snake->blocks[0].coord).y = 300;
+	snake->blocks[0].key = D_KEY;
+	memset(snake->cells, 0, sizeof(snake->cells));
+	snake_mark(snake, snake->blocks[0].coord, 1);
+	return snake;
 }
 
 void destroy_snake(Snake* snake) {
 
-	struct Snake *tmp = first_node;
-	struct Snake *next = NULL;
-	while (tmp != NULL) {
-		next = tmp->next;
-		free(tmp);
-		tmp = next;
+	free(snake);
+}
+
+/** Fills the strip of a block adjacent to the side it is moving away from */
+static void fill_block_strip(coord_t block, int side, coord_t dir, int len,
+		unsigned int color) {
+
+	if (dir.x > 0)
+		vg_drawRect(block.x, block.y, len, side, color);
+	else if (dir.x < 0)
+		vg_drawRect(block.x + side - len, block.y, len, side, color);
+	else if (dir.y > 0)
+		vg_drawRect(block.x, block.y, side, len, color);
+	else if (dir.y < 0)
+		vg_drawRect(block.x, block.y + side - len, side, len, color);
+}
+
+/** Fills a block with the grass color, without covering the borders */
+static void clear_block(coord_t block, int side) {
+
+	int x = block.x, y = block.y, width = side, height = side;
+
+	if (x < BORDER_SIZE) {
+		width -= BORDER_SIZE - x;
+		x = BORDER_SIZE;
+	}
+	if (y < BORDER_SIZE) {
+		height -= BORDER_SIZE - y;
+		y = BORDER_SIZE;
+	}
+	if (x + width > MIDDLE_BORDER)
+		width = MIDDLE_BORDER - x;
+	if (y + height > V_RES - BORDER_SIZE)
+		height = V_RES - BORDER_SIZE - y;
+
+	if (width > 0 && height > 0)
+		vg_drawRect(x, y, width, height, GRASS_COLOR);
+}
+
+/** Draws the snake's head and tail blocks partially, given the motion's phase */
+static void draw_snake_motion(Game* game, unsigned int phase) {
+
+	Snake* snake = game->snake;
+	SnakeBlock* head = snake_head(snake);
+	SnakeBlock* tail = snake_tail(snake);
+	int side = snake->side;
+	int len = (phase + 1) * side / SNAKE_TICKS_PER_MOVE;
+	coord_t dir;
+
+	/* the tail leaves its old block towards the new tail */
+	if (game->tail_moving) {
+		dir.x = (tail->coord).x - game->tail_from.x;
+		dir.y = (tail->coord).y - game->tail_from.y;
+		if (len == side)
+			clear_block(game->tail_from, side);
+		else {
+			vg_drawRect(game->tail_from.x, game->tail_from.y, side, side,
+					snake->color);
+			fill_block_strip(game->tail_from, side, dir, len, GRASS_COLOR);
+		}
+	}
+
+	/* the head enters its new block from the previous one */
+	dir.x = (head->coord).x - game->head_from.x;
+	dir.y = (head->coord).y - game->head_from.y;
+	if (dir.x != 0 || dir.y != 0) {
+		/* the previous block is now part of the body, unless the tail left it */
+		if (!game->tail_moving || game->head_from.x != game->tail_from.x
+				|| game->head_from.y != game->tail_from.y)
+			vg_drawRect(game->head_from.x, game->head_from.y, side, side,
+					snake->color);
+		clear_block(head->coord, side);
+		fill_block_strip(head->coord, side, dir, len, snake->color);
 	}
-	first_node = NULL;
-	last_node = NULL;
+
+	/* the animated head follows the head's front */
+	if (game->head_anim != NULL) {
+		animation_set_frames(game->head_anim,
+				head_row(head->key) * HEAD_FRAMES);
+		animation_move(game->head_anim,
+				(head->coord).x + dir.x * (len - side) / side,
+				(head->coord).y + dir.y * (len - side) / side);
+		animation_draw(game->head_anim);
+	}
+}
+
+void target_letter(Game* game, Word word, unsigned int letter_index) {
+
+	animation_stop(&game->animator, game->letter_anim);
+	game->letter_anim = NULL;
+
+	if (game->letter_sprites == NULL || letter_index >= word.n_letters_kbd)
+		return;
+
+	const GlyphMask* glyph = font_glyph(game->font, word.letters[letter_index]);
+	if (glyph == NULL)
+		return;
+
+	/* the letter's tile gradually brightens, its glyph recolored each frame */
+	Surface* frames = game->letter_sprites->surface;
+	const GlyphSet* glyphs = game->font->glyphs;
+	uint32_t paper = glyphs->paper == BG_COLOR ? GRASS_COLOR : glyphs->paper;
+	unsigned int frame;
+	int i;
+	for (frame = 0; frame < LETTER_FRAMES; frame++) {
+		unsigned int alpha = frame * 160 / (LETTER_FRAMES - 1);
+		int left = frame * LETTER_SIZE;
+		glyph_blit(frames, glyph, blend_color(glyphs->ink, WHITE, alpha),
+				blend_color(paper, WHITE, alpha), left, 0);
+
+		uint32_t border = blend_color(LETTER_BORDER_COLOR, WHITE, alpha);
+		for (i = 0; i < LETTER_SIZE; i++) {
+			surface_put_pixel(frames, left + i, 0, border);
+			surface_put_pixel(frames, left + i, LETTER_SIZE - 1, border);
+			surface_put_pixel(frames, left, i, border);
+			surface_put_pixel(frames, left + LETTER_SIZE - 1, i, border);
+		}
+	}
+
+	game->letter_anim = animation_play(&game->animator, game->letter_sprites, 0,
+			LETTER_FRAMES, ANIM_TICKS, ANIM_PINGPONG,
+			word.coord_kbd[letter_index].x, word.coord_kbd[letter_index].y);
 }
 
-void print_snake(Game* game, Word word, unsigned int letter_index) {
+void print_snake(Game* game, Word word, unsigned int letter_index,
+		int redraw) {
+
+	/* a single move only changes the head's and the tail's blocks */
+	if (!redraw) {
+		print_snake_motion(game, 0);
+		return;
+	}
 
 	vg_snake_clear();
 
 	spawn_letters(game, word, letter_index, 1);
 
-	Snake* tmp = NULL;
-	for (tmp = first_node; tmp != NULL; tmp = tmp->next) {
+	Snake* snake = game->snake;
+	unsigned int block;
+	for (block = 0; block < snake->length; block++) {
+		coord_t coord = snake_block(snake, block)->coord;
 		size_t i, j;
-		for (i = 0; i < game->snake->side; i++)
-			for (j = 0; j < game->snake->side; j++)
-				draw_pixel((tmp->coord).x + i, (tmp->coord).y + j, tmp->color);
+		for (i = 0; i < snake->side; i++)
+			for (j = 0; j < snake->side; j++)
+				draw_pixel(coord.x + i, coord.y + j, snake->color);
 	}
 
-	vg_copy();
+	draw_snake_motion(game, 0);
+	animator_redraw(&game->animator);
+
+	vg_copy_rect(0, 0, MIDDLE_BORDER + BORDER_SIZE, V_RES);
+}
+
+void print_snake_motion(Game* game, unsigned int phase) {
+
+	int side = game->snake->side;
+
+	draw_snake_motion(game, phase);
+
+	if (game->tail_moving)
+		vg_copy_rect(game->tail_from.x, game->tail_from.y, side, side);
+	vg_copy_rect(game->head_from.x, game->head_from.y, side, side);
+	vg_copy_rect((snake_head(game->snake)->coord).x,
+			(snake_head(game->snake)->coord).y, side, side);
 }
 
-void update_snake(unsigned long scancode) {
+void update_snake(Snake* snake, unsigned long scancode) {
 
 	int success = 1;
-	Snake* block = pop_front();
+	SnakeBlock* head = snake_head(snake);
+	SnakeBlock block;
 
 	switch (scancode) {
 	case W_KEY:
 		printf("W_KEY PRESSED\n");
-		if (last_node->key != S_KEY) {
-			block->key = W_KEY;
-			(block->coord).x = (last_node->coord).x;
-			(block->coord).y = (last_node->coord).y - block->side;
+		if (head->key != S_KEY) {
+			block.key = W_KEY;
+			(block.coord).x = (head->coord).x;
+			(block.coord).y = (head->coord).y - snake->side;
 		} else {
-			block->key = S_KEY;
-			(block->coord).x = (last_node->coord).x;
-			(block->coord).y = (last_node->coord).y + block->side;
+			block.key = S_KEY;
+			(block.coord).x = (head->coord).x;
+			(block.coord).y = (head->coord).y + snake->side;
 		}
 		break;
 	case A_KEY:
 		printf("A_KEY PRESSED\n");
-		if (last_node->key != D_KEY) {
-			block->key = A_KEY;
-			(block->coord).x = (last_node->coord).x - block->side;
-			(block->coord).y = (last_node->coord).y;
+		if (head->key != D_KEY) {
+			block.key = A_KEY;
+			(block.coord).x = (head->coord).x - snake->side;
+			(block.coord).y = (head->coord).y;
 		} else {
-			block->key = D_KEY;
-			(block->coord).x = (last_node->coord).x + block->side;
-			(block->coord).y = (last_node->coord).y;
+			block.key = D_KEY;
+			(block.coord).x = (head->coord).x + snake->side;
+			(block.coord).y = (head->coord).y;
 		}
 		break;
 	case S_KEY:
 		printf("S_KEY PRESSED\n");
-		if (last_node->key != W_KEY) {
-			block->key = S_KEY;
-			(block->coord).x = (last_node->coord).x;
-			(block->coord).y = (last_node->coord).y + block->side;
+		if (head->key != W_KEY) {
+			block.key = S_KEY;
+			(block.coord).x = (head->coord).x;
+			(block.coord).y = (head->coord).y + snake->side;
 		} else {
-			block->key = W_KEY;
-			(block->coord).x = (last_node->coord).x;
-			(block->coord).y = (last_node->coord).y - block->side;
+			block.key = W_KEY;
+			(block.coord).x = (head->coord).x;
+			(block.coord).y = (head->coord).y - snake->side;
 		}
 		break;
 	case D_KEY:
 		printf("D_KEY PRESSED\n");
-		if (last_node->key != A_KEY) {
-			block->key = D_KEY;
-			(block->coord).x = (last_node->coord).x + block->side;
-			(block->coord).y = (last_node->coord).y;
+		if (head->key != A_KEY) {
+			block.key = D_KEY;
+			(block.coord).x = (head->coord).x + snake->side;
+			(block.coord).y = (head->coord).y;
 		} else {
-			block->key = A_KEY;
-			(block->coord).x = (last_node->coord).x - block->side;
-			(block->coord).y = (last_node->coord).y;
+			block.key = A_KEY;
+			(block.coord).x = (head->coord).x - snake->side;
+			(block.coord).y = (head->coord).y;
 		}
 		break;
 	default:
@@ -779,58 +1351,37 @@ void update_snake(unsigned long scancode) {
 		break;
 	}
 
-	if (success)
-		push_back(block);
+	/* the tail's slot past the head becomes the new head, the tail leaves
+	 * its cell before the head enters its own */
+	if (success) {
+		snake_mark(snake, snake_tail(snake)->coord, -1);
+		snake->tail = (snake->tail + 1) % SNAKE_CAPACITY;
+		*snake_head(snake) = block;
+		snake_mark(snake, block.coord, 1);
+	}
 }
 
-int test_collision_snake(Snake* snake, Word word, int letter_index) {
+int test_collision_snake(Snake* snake, Word word, LetterIndex* letters,
+		int letter_index) {
+
+	SnakeBlock* head = snake_head(snake);
 
 	/* test collision with the middle and screen borders */
-	if ((last_node->coord).x >= MIDDLE_BORDER
-			|| ((last_node->coord).x + snake->side / 2) <= 0
-			|| (last_node->coord).y >= V_RES
-			|| ((last_node->coord).y + snake->side / 2) <= 0)
+	if ((head->coord).x >= MIDDLE_BORDER
+			|| ((head->coord).x + snake->side / 2) <= 0
+			|| (head->coord).y >= V_RES
+			|| ((head->coord).y + snake->side / 2) <= 0)
 		return 1;
 
 	else {
-		/* test collision in snake's body itself */
-		Snake* tmp = NULL;
-		for (tmp = first_node; tmp != last_node; tmp = tmp->next) {
-			if ((last_node->coord).x == (tmp->coord).x
-					&& (last_node->coord).y == (tmp->coord).y) {
-				return 1;
-			}
-		}
-
-		/* test collision with letters on the screen */
-		size_t i;
-		for (i = letter_index; i < word.n_letters_kbd; i++) {
+		/* test collision in snake's body itself, the head shares its cell */
+		if (snake_occupies(snake, head->coord) > 1)
+			return 1;
 
-			int equal_x = word.coord_kbd[i].x == last_node->coord.x;
-			int distance_y = abs(word.coord_kbd[i].y - last_node->coord.y);
-			int equal_y = (word.coord_kbd[i].y == last_node->coord.y);
-			int distance_x = abs(word.coord_kbd[i].x - last_node->coord.x);
-
-			/* if blocks collided horizontally or vertically */
-			if ((equal_x && distance_y < 20) || (equal_y && distance_x < 20)) {
-
-				/* if letter eaten is in the correct order */
-				if (i != letter_index) {
-
-					/* if eaten letter has more than 2 appearances on the word */
-					if (word.letters[i] == word.letters[letter_index]) {
-						coord_t temp = word.coord_kbd[i];
-						word.coord_kbd[i] = word.coord_kbd[letter_index];
-						word.coord_kbd[letter_index] = temp;
-						return 2;
-					}
-
-					return 1;
-				}
-
-				return 2;
-			}
-		}
+		/* test collision with the letter on the head's cell */
+		uint16_t* cell = letter_cell(letters, (head->coord).x, (head->coord).y);
+		if (cell != NULL && *cell > letter_index)
+			return hit_letter(word, word.coord_kbd, letters, *cell - 1, letter_index);
 
 		return 0;
 	}
@@ -839,10 +1390,12 @@ int test_collision_snake(Snake* snake, Word word, int letter_index) {
 int main_menu(Game* game) {
 
 	unsigned long status, outbuff_trash;
+	int irq_timer = BIT(game->hookid_timer);
 	int irq_mouse = BIT(game->hookid_mouse);
 	int ipc_status;
 	int r;
 	message msg;
+	unsigned int idle_ticks = 0, n_deferred = 1;
 
 	/* clear OUT_BUF */
 	readStatusRegister(&status);
@@ -850,6 +1403,9 @@ int main_menu(Game* game) {
 		readOutBuffer(&outbuff_trash);
 	}
 
+	/* first menu frame, before any mouse packet */
+	print_menu(game);
+
 	while (game->current_state != LEAVE) {
 		/* Get a request message. */
 		if ((r = driver_receive(ANY, &msg, &ipc_status)) != 0) {
@@ -859,6 +1415,28 @@ int main_menu(Game* game) {
 		if (is_ipc_notify(ipc_status)) { /* received notification */
 			switch (_ENDPOINT_P(msg.m_source)) {
 			case HARDWARE: /* hardware interrupt notification */
+				if (msg.NOTIFY_ARG & irq_timer) {
+					/* time stamp counter's frequency, for the startup profile */
+					profile_tick(SECONDS_TO_TICKS(1));
+
+					/* animations only redraw what changed */
+					if (animator_update(&game->animator) > 0) {
+						Cursor* cursor = game->cursor;
+						if (animator_damaged(&game->animator, (cursor->coord).x,
+								(cursor->coord).y, cursor->width, cursor->height))
+							print_cursor(cursor);
+						animator_present(&game->animator);
+					}
+
+					/* deferred assets are loaded one at a time while idle */
+					if (n_deferred > 0 && ++idle_ticks >= MENU_IDLE_TICKS) {
+						n_deferred = asset_idle();
+						/* the font is compiled as soon as every image is loaded */
+						if (n_deferred == 0 && game->font == NULL)
+							game->font = initialize_font();
+					}
+				}
+
 				if (msg.NOTIFY_ARG & irq_mouse) { /* subscribed mouse interrupt */
 					/* read status register */
 					readOutBuffer(&g_byte);
@@ -875,10 +1453,13 @@ int main_menu(Game* game) {
 					if (g_count_bytes == 3) {
 						/* reset packet array index */
 						g_count_bytes = 0;
+						idle_ticks = 0;
 						/* update cursor's position */
+						coord_t from = game->cursor->coord;
 						update_cursor(game->cursor, 1);
-						/* print mouse's new position */
-						print_cursor(game->cursor, game->menu);
+						/* print mouse's new position, presenting only
+						 * where it was and where it is */
+						print_menu_cursor(game, from);
 						/* menu options handling */
 						menu_handling(game);
 					}
@@ -902,6 +1483,14 @@ int main_menu(Game* game) {
 	return 0;
 }
 
+/** Copies the screen into a transition's first or last frame, unless screens cut */
+static void capture_screen(const Game* game, int last) {
+
+	if (game->transition != NULL)
+		surface_copy(last ? game->transition->to : game->transition->from,
+				vg_back_buffer(), 0, 0, H_RES, V_RES);
+}
+
 int play_game(Game* game) {
 
 	unsigned long status, outbuff_trash;
@@ -918,13 +1507,43 @@ int play_game(Game* game) {
 		readOutBuffer(&outbuff_trash);
 	}
 
+	/* the snake hasn't moved yet */
+	game->head_from = snake_head(game->snake)->coord;
+	game->tail_moving = 0;
+
 	/* game state indicators */
 	int lvl_kbd = 0, lvl_mouse = 0, kbd_hit = 0;
 	int letter_index_kbd = 0, letter_index_mouse = 0;
 	unsigned long count = 0;
-
+	int cursor_moved = 1, cursor_deferred = 0;
+	/* the snake's part of the screen is redrawn whole for a new word */
+	int redraw = 1;
+
+	/* letters are looked up by cell in the collision tests */
+	place_word(&game->words[lvl_kbd], game->snake);
+	index_letters(&game->kbd_letters, game->words[lvl_kbd].coord_kbd,
+			game->words[lvl_kbd].n_letters_kbd);
+	index_letters(&game->mouse_letters, game->words[lvl_mouse].coord_mouse,
+			game->words[lvl_mouse].n_letters_mouse);
+
+	/* the tick's period from the counter's rate, calibrated in the menu */
+	governor_init(&game->governor, (uint64_t) profile_cycles_per_ms() * 1000
+			/ SECONDS_TO_TICKS(1));
+
+	/* wipe from the menu into the playing field */
+	capture_screen(game, 0);
 	vg_snake_clear();
 	vg_cursor_clear();
+	capture_screen(game, 1);
+	play_transition(game, WIPE, WIPE_FRAMES, 0);
+
+	/* animated snake's head and next letter to be eaten */
+	if (game->head_sprites != NULL)
+		game->head_anim = animation_play(&game->animator, game->head_sprites,
+				head_row(snake_head(game->snake)->key) * HEAD_FRAMES, HEAD_FRAMES,
+				2 * ANIM_TICKS, ANIM_LOOP, (snake_head(game->snake)->coord).x,
+				(snake_head(game->snake)->coord).y);
+	target_letter(game, game->words[lvl_kbd], letter_index_kbd);
 
 	int snakeWon = 0, cursorWon = 0;
 	while (!(snakeWon || cursorWon)) {
@@ -938,24 +1557,34 @@ int play_game(Game* game) {
 			case HARDWARE: /* hardware interrupt notification */
 
 				if (msg.NOTIFY_ARG & irq_timer) {
-					count++;
-					/* 15fps per second */
-					if (count % 4 == 0) {
+					/* logic runs for every elapsed tick, even late ones */
+					unsigned int ticks = governor_tick(&game->governor);
+					unsigned int elapsed = ticks;
+					int moved = 0, letter_changed = 0;
+					while (ticks-- > 0 && !(snakeWon || cursorWon)) {
+						count++;
+						/* 15 moves per second */
+						if (count % SNAKE_TICKS_PER_MOVE != 0)
+							continue;
+
+						moved++;
+						/* remember where the head and tail come from */
+						game->head_from = snake_head(game->snake)->coord;
+						game->tail_from = snake_tail(game->snake)->coord;
+						game->tail_moving = 1;
+
 						/* if some key was pressed */
 						if (kbd_hit) {
-							update_snake(g_scancode);
+							update_snake(game->snake, g_scancode);
 							kbd_hit = 0;
 						} else {
-							update_snake(last_node->key);
+							update_snake(game->snake, snake_head(game->snake)->key);
 						}
 
-						/* prints snake on the screen */
-						print_snake(game, game->words[lvl_kbd],
-								letter_index_kbd);
-
 						/* test for collision */
 						switch (test_collision_snake(game->snake,
-								game->words[lvl_kbd], letter_index_kbd)) {
+								game->words[lvl_kbd], &game->kbd_letters,
+								letter_index_kbd)) {
 						case 0:
 							/* no collisions */
 							break;
@@ -965,14 +1594,29 @@ int play_game(Game* game) {
 							cursorWon = 1;
 							break;
 						case 2:
+							/* burst over the letter eaten */
+							if (game->particles != NULL)
+								particles_emit(game->particles,
+										game->words[lvl_kbd].coord_kbd[letter_index_kbd].x + LETTER_SIZE / 2,
+										game->words[lvl_kbd].coord_kbd[letter_index_kbd].y + LETTER_SIZE / 2,
+										EATEN_PARTICLES, EATEN_SPEED, EATEN_LIFE, WHITE);
 							letter_index_kbd++;
+							letter_changed = 1;
 							spawn_block(game->snake);
+							/* the tail stays where it was, so the snake grows */
+							game->tail_moving = 0;
 							if (letter_index_kbd
 									== game->words[lvl_kbd].n_letters_kbd) {
 								letter_index_kbd = 0;
 								lvl_kbd++;
 								if (lvl_kbd == game->n_words) {
 									snakeWon = 1;
+								} else {
+									place_word(&game->words[lvl_kbd], game->snake);
+									redraw = 1;
+									index_letters(&game->kbd_letters,
+											game->words[lvl_kbd].coord_kbd,
+											game->words[lvl_kbd].n_letters_kbd);
 								}
 							}
 							break;
@@ -981,6 +1625,54 @@ int play_game(Game* game) {
 							break;
 						}
 					}
+
+					if (!(snakeWon || cursorWon)) {
+						governor_render_begin(&game->governor);
+
+						/* particles are drawn over everything else */
+						if (game->particles != NULL)
+							particles_erase(game->particles);
+
+						if (letter_changed)
+							target_letter(game, game->words[lvl_kbd],
+									letter_index_kbd);
+
+						/* prints snake on the screen, whole for a new word or when
+						 * a late batch made several moves */
+						if (moved) {
+							print_snake(game, game->words[lvl_kbd],
+									letter_index_kbd, redraw || moved > 1);
+							redraw = 0;
+						}
+						/* interpolates snake's motion between moves */
+						else if (governor_allow_frame(&game->governor))
+							print_snake_motion(game, count % SNAKE_TICKS_PER_MOVE);
+
+						/* animations only redraw what changed */
+						if (animator_update(&game->animator) > 0)
+							animator_present(&game->animator);
+
+						/* one cursor present per tick, however many packets arrived */
+						/* a deferred cursor is drawn on the next tick, whatever the budget */
+						if (cursor_moved && (cursor_deferred
+								|| governor_allow_frame(&game->governor))) {
+							clean_cursor(game, game->words[lvl_mouse],
+									letter_index_mouse);
+							print_cursor(game->cursor);
+							vg_copy_rect(MIDDLE_BORDER, 0, H_RES - MIDDLE_BORDER, V_RES);
+							cursor_moved = 0;
+							cursor_deferred = 0;
+						} else if (cursor_moved)
+							cursor_deferred = 1;
+
+						if (game->particles != NULL) {
+							particles_update(game->particles, elapsed);
+							particles_draw(game->particles);
+							particles_present(game->particles);
+						}
+
+						governor_render_end(&game->governor);
+					}
 				}
 
 				if (msg.NOTIFY_ARG & irq_kbd) {
@@ -1011,26 +1703,36 @@ int play_game(Game* game) {
 					if (g_count_bytes == 3) {
 						/* reset packet array index */
 						g_count_bytes = 0;
-						/* clean cursor last position */
-						clean_cursor(game, game->words[lvl_mouse],
-								letter_index_mouse);
 						/* update cursor's position */
 						update_cursor(game->cursor, 0);
-						/* print mouse's new position */
-						print_cursor(game->cursor, NULL);
+						/* cursor is printed on the next timer tick */
+						cursor_moved = 1;
 
 						if (g_packet[0] & LB) {
 							/* test for collision */
 							switch (test_collision_cursor(game->cursor,
-									game->words[lvl_mouse], letter_index_mouse)) {
+									game->words[lvl_mouse], &game->mouse_letters,
+									letter_index_mouse)) {
 							case 0:
-								/* no collisions */
+								/* puff where nothing was clicked */
+								if (game->particles != NULL)
+									particles_emit(game->particles,
+											(game->cursor->coord).x,
+											(game->cursor->coord).y,
+											MISCLICK_PARTICLES, MISCLICK_SPEED,
+											MISCLICK_LIFE, LETTER_BORDER_COLOR);
 								break;
 							case 1:
 								/* collision with wrong letter */
 								snakeWon = 1;
 								break;
 							case 2:
+								/* burst over the letter clicked */
+								if (game->particles != NULL)
+									particles_emit(game->particles,
+											game->words[lvl_mouse].coord_mouse[letter_index_mouse].x + LETTER_SIZE / 2,
+											game->words[lvl_mouse].coord_mouse[letter_index_mouse].y + LETTER_SIZE / 2,
+											EATEN_PARTICLES, EATEN_SPEED, EATEN_LIFE, WHITE);
 								letter_index_mouse++;
 								if (letter_index_mouse
 										== game->words[lvl_mouse].n_letters_kbd) {
@@ -1038,7 +1740,10 @@ int play_game(Game* game) {
 									lvl_mouse++;
 									if (lvl_mouse == game->n_words) {
 										cursorWon = 1;
-									}
+									} else
+										index_letters(&game->mouse_letters,
+												game->words[lvl_mouse].coord_mouse,
+												game->words[lvl_mouse].n_letters_mouse);
 								}
 								break;
 							default:
@@ -1058,6 +1763,9 @@ int play_game(Game* game) {
 		}
 	}
 
+	printf("Frames skipped: %lu, late ticks: %lu\n",
+			game->governor.skipped_frames, game->governor.late_ticks);
+
 	handle_event(game, END_GAME);
 
 	/* disable mouse */
@@ -1066,11 +1774,11 @@ int play_game(Game* game) {
 	/* prints victory screen */
 	if (snakeWon) {
 		write_winner(1);
-		victory_screen(game->menu, "snake");
+		victory_screen(game, "snake");
 	}
 	else if (cursorWon) {
 		write_winner(0);
-		victory_screen(game->menu, "cursor");
+		victory_screen(game, "cursor");
 	}
 
 	/* enable mouse */
@@ -1112,13 +1820,86 @@ int write_winner(int winner) {
 	return 0;
 }
 
-void victory_screen(Menu* menu, char* winner) {
+int play_transition(Game* game, transition_type_t type, unsigned int n_frames,
+		unsigned int hold_ticks) {
 
+	int irq_timer = BIT(game->hookid_timer);
+	int irq_kbd = BIT(game->hookid_kbd);
+	int irq_mouse = BIT(game->hookid_mouse);
+	int ipc_status;
+	int r;
+	message msg;
+
+	/* without transitions the screen just cuts, then holds */
+	int running = game->transition != NULL
+			&& transition_start(game->transition, type, n_frames);
+	if (!running)
+		vg_copy();
+
+	while (running || hold_ticks > 0) {
+		/* Get a request message. */
+		if ((r = driver_receive(ANY, &msg, &ipc_status)) != 0) {
+			printf("driver_receive failed with: %d", r);
+			continue;
+		}
+		if (is_ipc_notify(ipc_status)) { /* received notification */
+			switch (_ENDPOINT_P(msg.m_source)) {
+			case HARDWARE: /* hardware interrupt notification */
+				if (msg.NOTIFY_ARG & irq_timer) {
+					/* one frame per timer interrupt */
+					if (running)
+						running = transition_step(game->transition);
+					else
+						hold_ticks--;
+				}
+
+				/* input is ignored while the transition plays */
+				if (msg.NOTIFY_ARG & irq_kbd)
+					kbd_asm_handler();
+
+				if (msg.NOTIFY_ARG & irq_mouse)
+					readOutBuffer(&g_byte);
+				break;
+			default:
+				break; /* no other notifications expected: do nothing */
+			}
+		} else { /* received a standard message, not a notification */
+			/* no standard messages expected: do nothing */
+		}
+	}
+
+	/* mouse packets were interrupted, so wait for a new first byte */
+	g_count_bytes = 0;
+
+	return 0;
+}
+
+void victory_screen(Game* game, char* winner) {
+
+	Menu* menu = game->menu;
+	IndexedSurface* victory = NULL;
+
+	/* crossfade from the playing field into the victory screen */
+	capture_screen(game, 0);
+
+	/* already loaded, unless the menu was never idle long enough */
 	if (strncmp(winner, "snake", strlen("snake")) == 0)
-		vg_png(menu->snake_victory, menu->width, menu->height, 0, 0);
+		victory = asset_acquire_indexed(SNAKE_VICT_IMGPATH);
 	else if (strncmp(winner, "cursor", strlen("cursor")) == 0)
-		vg_png(menu->cursor_victory, menu->width, menu->height, 0, 0);
+		victory = asset_acquire_indexed(CURSOR_VICT_IMGPATH);
 
-	vg_copy();
-	sleep(5);
+	if (victory != NULL) {
+		vg_indexed(victory, 0, 0);
+		asset_release(victory);
+	}
+
+	capture_screen(game, 1);
+	play_transition(game, CROSSFADE, CROSSFADE_FRAMES,
+			VICTORY_TICKS - CROSSFADE_FRAMES);
+
+	/* wipe from the victory screen into the menu */
+	capture_screen(game, 0);
+	print_background(menu);
+	capture_screen(game, 1);
+	play_transition(game, WIPE, WIPE_FRAMES, 0);
 }
@@ -1,6 +1,16 @@
 #ifndef __GAME_H
 #define __GAME_H
 
+#include "transition.h"
+#include "governor.h"
+#include "sprite.h"
+#include "particles.h"
+#include "atlas.h"
+#include "glyph.h"
+#include "asset.h"
+#include "video_gr.h"
+#include "dictionary.h"
+
 /**
  * @file game.h
  */
@@ -12,8 +22,17 @@
  *	Functions implementing the game's logic
  */
 
+/* Asset pack, holding every resource below */
+#define PACK_FILEPATH		"/home/snaktionary/res/snaktionary.pack"
+#define WORDS_PACKNAME		"words.txt"
+#define WORDS_DICT_PACKNAME	"words.dict"
+
+/* Startup profile's log */
+#define PROFILE_LOG_FILEPATH	"/home/snaktionary/res/startup.log"
+
 /* PNG image paths */
 #define WORDS_FILEPATH		"/home/snaktionary/res/words.txt"
+#define WORDS_DICT_FILEPATH	"/home/snaktionary/res/words.dict"
 #define WINNERS_FILEPATH	"/home/snaktionary/res/winners.txt"
 #define FONT_IMGPATH		"/home/snaktionary/res/font.png"
 #define CURSOR_IMGPATH		"/home/snaktionary/res/cursor.png"
@@ -29,10 +48,56 @@
 #define S_KEY	0x1f
 #define D_KEY	0x20
 
+/* Snake's block side size */
+#define SNAKE_SIDE	20
+
+/* Snake's part of the screen, in blocks */
+#define SNAKE_COLUMNS	((MIDDLE_BORDER + SNAKE_SIDE - 1) / SNAKE_SIDE)
+#define SNAKE_ROWS		(V_RES / SNAKE_SIDE)
+
+/* Snake's maximum number of blocks, one per block of its part of the screen */
+#define SNAKE_CAPACITY	(SNAKE_COLUMNS * SNAKE_ROWS)
+
+/* Timer interrupts per snake move (15 moves per second) */
+#define SNAKE_TICKS_PER_MOVE	4
+
+/* Sprite animations */
+#define ANIM_TICKS		4	/* timer ticks per animation frame */
+#define GLOW_FRAMES		8	/* frames of the menu buttons' glow */
+#define HEAD_FRAMES		8	/* frames of the snake's head, per direction */
+#define LETTER_FRAMES	6	/* frames of the next letter's pulse */
+#define LETTER_SIZE		16	/* font's letter tile size */
+#define LETTER_CELL		20	/* spacing of the grid letters are placed on */
+#define LETTER_REACH	16	/* cursor's distance to a letter it clicks, per axis */
+#define SPAWN_DISTANCE	50	/* letters' distance to the snake's head, on both axes */
+#define WORD_DECOYS		20	/* deceiving letters the mouse gets, per word */
+#define MATCH_WORDS		10	/* words of a match, drawn from the dictionary */
+#define MATCH_MIN_LENGTH	3	/* letters of a match's first word */
+#define MATCH_MAX_LENGTH	8	/* letters of a match's last word */
+#define MATCH_TRIES		4	/* draws of a word already picked before any word will do */
+
+/* Letters' grid, over the whole screen */
+#define LETTER_COLUMNS	(H_RES / LETTER_CELL)
+#define LETTER_ROWS		(V_RES / LETTER_CELL)
+
+/* Particle effects */
+#define EATEN_PARTICLES		400		/* burst of a letter eaten */
+#define EATEN_SPEED			3		/* pixels per tick */
+#define EATEN_LIFE			40		/* timer ticks */
+#define MISCLICK_PARTICLES	60		/* puff of a click on nothing */
+#define MISCLICK_SPEED		1
+#define MISCLICK_LIFE		20
+
 /* Game's borders size */
 #define BORDER_SIZE		5
 #define MIDDLE_BORDER	495
 
+/* Timer ticks without mouse packets before the menu loads deferred assets */
+#define MENU_IDLE_TICKS	6
+
+/* Victory screen's duration in timer ticks */
+#define VICTORY_TICKS	SECONDS_TO_TICKS(5)
+
 /**
  *	@brief Outputs the name of the winner
  */
@@ -63,32 +128,29 @@ typedef struct Cursor {
 	coord_t coord;			/**< Cursor's coordinates */
 	int width;				/**< Cursor's image width */
 	int height;				/**< Cursor's image height */
-	unsigned char* image;	/**< Cursor's png image */
+	int sprite;				/**< Cursor's sprite in the atlas */
 } Cursor;
 
 /**
  * @brief Game's menu
 */
 typedef struct Menu {
-	int width;							/**< Menu's image width */
-	int height;							/**< Menu's image height */
 	coord_t* play_button;					/**< Menu's play button coordinates on the screen */
 	coord_t* exit_button;					/**< Menu's exit button coordinates on the screen */
-	unsigned char* menu;				/**< Menu's main png image */
-	unsigned char* menu_play;			/**< Menu's png image with play button selected */
-	unsigned char* menu_exit;			/**< Menu's png image with exit button selected */
-	unsigned char* snake_victory;		/**< Snake's victory png image */
-	unsigned char* cursor_victory;		/**< Cursor's victory png image */
-	unsigned char* current_background;	/**< Menu's current png image */
+	IndexedSurface* menu;				/**< Menu's main image */
+	Patch* menu_play;					/**< Menu's patch with play button selected, NULL until hovered */
+	Patch* menu_exit;					/**< Menu's patch with exit button selected, NULL until hovered */
+	Patch* hover;						/**< Patch of the button being hovered, NULL if none */
+	SpriteSheet* play_glow;				/**< Play button's glow frames, NULL until hovered */
+	SpriteSheet* exit_glow;				/**< Exit button's glow frames, NULL until hovered */
+	Animation* glow;					/**< Glow of the button being hovered */
 } Menu;
 
 /**
  * @brief Game's in-game font
 */
 typedef struct Font {
-	int width;					/**< Font's image width */
-	int height;					/**< Font's image height */
-	unsigned char* font_img;	/**< Font's png image */
+	GlyphSet* glyphs;			/**< Font's 16x16 glyph masks and colors, the first one '0' */
 } Font;
 
 /**
@@ -102,15 +164,31 @@ typedef struct Word {
 	unsigned int n_letters_mouse;	/**< Word's number of letters plus deceiving mouse letters */
 } Word;
 
+/**
+ * @brief Letters of a word's half of the screen, by the grid cell they're on
+*/
+typedef struct LetterIndex {
+	uint16_t slots[LETTER_ROWS][LETTER_COLUMNS];	/**< Letter's index in the word plus 1, 0 if none */
+} LetterIndex;
+
 /**
  * @brief Game's snake block
 */
-typedef struct Snake {
+typedef struct SnakeBlock {
 	coord_t coord;			/**< Snake's block coordinates on the screen */
-	int side;				/**< Snake's block side size */
 	unsigned long key;		/**< Snake's block moving direction */
-	unsigned long color;	/**< Snake's block color */
-	struct Snake* next;		/**< Snake's next block */
+} SnakeBlock;
+
+/**
+ * @brief Game's snake, a circular buffer of blocks from its tail to its head
+*/
+typedef struct Snake {
+	int side;								/**< Snake's blocks side size */
+	unsigned long color;					/**< Snake's blocks color */
+	unsigned int tail;						/**< Tail block's index in the buffer */
+	unsigned int length;					/**< Snake's number of blocks */
+	SnakeBlock blocks[SNAKE_CAPACITY];		/**< Snake's blocks, wrapping around */
+	uint8_t cells[SNAKE_ROWS][SNAKE_COLUMNS];	/**< Number of blocks on each cell of its part of the screen */
 } Snake;
 
 /**
@@ -122,10 +200,25 @@ typedef struct Game {
 	int hookid_mouse;				/**< Mouse's irq line (12) */
 	Menu* menu;						/**< Game's menu */
 	Cursor* cursor;					/**< Game's cursor */
-	Font* font;
-	Word* words;					/**< Game's words */
+	Font* font;						/**< Game's font, NULL until it's compiled */
+	Dictionary* dictionary;			/**< Game's dictionary */
+	Word* words;					/**< Match's words */
 	Snake* snake;					/**< Game's snake */
+	Transition* transition;			/**< Game's screen transition */
+	coord_t head_from;				/**< Cell the snake's head left on its last move */
+	coord_t tail_from;				/**< Cell the snake's tail left on its last move */
+	int tail_moving;				/**< Whether the snake's tail left a cell on its last move */
+	Governor governor;				/**< Game's frame-budget governor */
+	Animator animator;				/**< Game's sprite animations */
+	SpriteSheet* head_sprites;		/**< Snake head's frames, one row per direction */
+	Animation* head_anim;			/**< Snake head's animation */
+	SpriteSheet* letter_sprites;	/**< Next letter's pulse frames */
+	Animation* letter_anim;			/**< Next letter's animation */
+	ParticleSystem* particles;		/**< Game's particle effects */
+	LetterIndex kbd_letters;		/**< Snake's word letters, by cell */
+	LetterIndex mouse_letters;		/**< Cursor's word letters, by cell */
 	unsigned int n_words;			/**< Game's number of words */
+	unsigned short video_mode;		/**< VBE mode the game runs in */
 	game_state_t current_state;		/**< Game's current state */
 } Game;
 
@@ -194,7 +287,7 @@ void destroy_cursor(Cursor* cursor);
 /**
  *  @brief Cursor's clean function
  *
- * 	Cleans cursor's position at some moment.
+ * 	Cleans cursor's position at some moment. The screen isn't presented.
  *
  *	@param Game Game's struct
  *	@param word Word currently being printed on the screen
@@ -205,14 +298,34 @@ void clean_cursor(Game* game, Word word, int letter_index);
 /**
  *  @brief Prints game's cursor on the screen
  *
- *  Function to print the cursor on the screen based on its current background,
- *  defined in the game's menu. If parameter "menu" is passed as being NULL, the
- *  cursor is printed over no background.
+ *  Function to draw the cursor over the current screen. The caller must
+ *  present it.
  *
  *  @param cursor Game's cursor
- *  @param menu	Game's menu
  */
-void print_cursor(Cursor* cursor, Menu* menu);
+void print_cursor(Cursor* cursor);
+
+/**
+ *  @brief Prints game's menu on the screen
+ *
+ *  Draws the menu's current background, the animations playing over it and
+ *  the cursor, presenting the whole screen. Used when the menu is entered.
+ *
+ *  @param game Pointer to game's struct
+ */
+void print_menu(Game* game);
+
+/**
+ *  @brief Moves the cursor over game's menu
+ *
+ *  Restores the menu under the cursor's previous position and draws the
+ *  cursor at its current one, presenting only those two areas. The whole
+ *  menu is only presented by print_menu(), when the menu is entered.
+ *
+ *  @param game Pointer to game's struct
+ *  @param from Cursor's previous coordinates
+ */
+void print_menu_cursor(Game* game, coord_t from);
 
 /**
  *  @brief Updates game's cursor position on the screen
@@ -231,20 +344,38 @@ void update_cursor(Cursor* cursor, int in_menu);
  *
  *	Tests any collision with the cursor, right after updating its position
  *	on the screen. Collision is detected when the player clicks the mouse's
- *	left-button on any letter on the screen.
+ *	left-button on any letter on the screen. Only letters on the cells around
+ *	the cursor are looked up.
  *
  *  @param cursor Game's cursor
  *  @param word Word to test collision with
+ *  @param letters Word's cursor letters, by cell
  *  @param letter_index Letter's index the snake is supposed to collide with
  *  @return Returns 0 on non-collision, 1 on collision with the wrong letter,
  *  2 if collision with the right letter occurs.
  */
-int test_collision_cursor(Cursor* cursor, Word word, int letter_index);
+int test_collision_cursor(Cursor* cursor, Word word, LetterIndex* letters,
+		int letter_index);
+
+/**
+ *  @brief Indexes a word's letters by cell
+ *
+ * 	Letters are placed on the LETTER_CELL grid. The index is kept up to date
+ * 	by the collision tests when duplicate letters swap places, and letters
+ * 	already eaten are told apart by their index.
+ *
+ *  @param letters Index to be filled
+ *  @param coords Letters' coordinates on the screen
+ *  @param n_letters Number of letters
+ */
+void index_letters(LetterIndex* letters, const coord_t* coords, unsigned int n_letters);
 
 /**
  *  @brief Game's font initializer
  *
- * 	Initializes the game's font.
+ * 	Initializes the game's font, compiling its image into glyph masks. The
+ * 	font is compiled once, either when the menu has loaded every deferred
+ * 	image or when the first match starts, and is kept until the game exits.
  *
  *	@return Returns pointer to the game's font
  */
@@ -260,20 +391,38 @@ Font* initialize_font();
 void destroy_font(Font* font);
 
 /**
- *  @brief Words reading function
+ *  @brief Match's words picking function
+ *
+ * 	Picks the match's words from the dictionary, MATCH_WORDS of them at
+ * 	random, or every word of a smaller dictionary, and places the mouse's
+ * 	letters on the screen. The snake's are placed by place_word(). A
+ * 	compiled dictionary gives longer and harder words as the match goes
+ * 	on. Words that don't fit on the screen are left out. Returns a pointer
+ * 	to the struct containing these word's information, allocated at once.
+ *
+ *	@param dictionary Game's dictionary
+ *	@param n_words Set to the number of words picked
+ *	@return Returns a pointer to the game's word struct, NULL without words
+ */
+Word* pick_words(const Dictionary* dictionary, unsigned int* n_words);
+
+/**
+ *  @brief Places the snake's letters of a word becoming active
  *
- * 	Reads all words from the "words.txt" file, allocating memory
- * 	for them to be added into the game. Returns a pointer to the
- * 	struct containing these word's information.
+ * 	Letters are placed on free cells, SPAWN_DISTANCE away from the snake's
+ * 	head on both axes and never under its body. A snake too long for that
+ * 	gets its letters off its body only, and one covering the whole half
+ * 	anywhere.
  *
- *	@return Returns a pointer to the game's word struct
+ *	@param word Word becoming active
+ *	@param snake Game's snake, as it is now
  */
-Word* read_words();
+void place_word(Word* word, Snake* snake);
 
 /**
  *  @brief Game's word destroyer
  *
- * 	Destroys the game's word database, freeing all memory allocated
+ * 	Destroys the match's words, freeing all memory allocated
  * 	to store them.
  *
  *	@param words Game's word struct to be destroyed
@@ -297,59 +446,45 @@ void destroy_words(Word* words);
 void spawn_letters(Game* game, Word word, unsigned int letter_index, int kbd);
 
 /**
- *  @brief Snake's node creator
- *
- * 	Creates a new block for the snake with the information
- * 	passed as a parameter.
- *
- *	@param info Information for the new snake block
- *	@return Returns pointer to the created snake node
- */
-Snake* new_node(Snake info);
-
-/**
- *  @brief Snake's push_front() function
- *
- * 	Inserts a new block into the front of the snake's linked-list,
- * 	passed as a parameter.
+ *  @brief Returns one of the snake's blocks
  *
- *	@param node Snake's node to be inserted
+ *	@param snake Game's snake
+ *	@param i Block's position, 0 being the tail
+ *	@return Returns pointer to the block
  */
-void push_front(Snake* node);
+SnakeBlock* snake_block(Snake* snake, unsigned int i);
 
 /**
- *  @brief Snake's push_back() function
+ *  @brief Returns the snake's head block
  *
- * 	Inserts a new block into the back of the snake's linked-list,
- * 	passed as a parameter.
- *
- *	@param node Snake's node to be inserted
+ *	@param snake Game's snake
+ *	@return Returns pointer to the head block
  */
-void push_back(Snake* node);
+SnakeBlock* snake_head(Snake* snake);
 
 /**
- *  @brief Snake's pop_front() function
- *
- * 	Erases the first element of the snake linked-list, returning it.
+ *  @brief Returns the snake's tail block
  *
- *	@return Returns pointer to the snake's block removed
+ *	@param snake Game's snake
+ *	@return Returns pointer to the tail block
  */
-Snake* pop_front();
+SnakeBlock* snake_tail(Snake* snake);
 
 /**
- *  @brief Snake's pop_back() function
+ *  @brief Tests whether the snake is on a cell
  *
- * 	Erases the last element of the snake linked-list, returning it.
- *
- *	@return Returns pointer to the snake's block removed
+ *	@param snake Game's snake
+ *	@param coord Cell's coordinates on the screen
+ *	@return Returns the number of the snake's blocks on the cell, 0 if none or
+ *	if it's outside the snake's part of the screen
  */
-Snake* pop_back();
+unsigned int snake_occupies(Snake* snake, coord_t coord);
 
 /**
  *  @brief Spawns a new block on the snake
  *
- * 	Creates a new block and using push_front() function inserts it
- * 	on the snake. The snake grows by 1 block.
+ * 	Adds a block behind the snake's tail, in place, so the snake grows by
+ * 	1 block. Nothing is added once the snake fills its part of the screen.
  *
  *	@param snake Snake struct
  */
@@ -359,7 +494,8 @@ void spawn_block(Snake* snake);
  *  @brief Game's snake initializer
  *
  * 	Initializes the game's snake with a block and returns
- * 	its created struct.
+ * 	its created struct. Blocks for its largest size are allocated
+ * 	right away, so it never allocates while playing.
  *
  *	@return Returns pointer to the game's snake
  */
@@ -380,39 +516,75 @@ void destroy_snake(Snake* snake);
  *  Function to print the snake on the screen. The current word is important
  *  while printing the snake, so is the index of the next letter to be eaten.
  *  Hence, after printing the snake, the letters left to be eaten of the
- *  current word are re-printed to the screen.
+ *  current word are re-printed to the screen. The snake's head and tail are
+ *  drawn at the start of their motion. Unless "redraw" is set, only the
+ *  blocks the last move changed are drawn and presented; otherwise the whole
+ *  snake's part of the screen is.
  *
  *  @param game Game's struct
  *  @param word Snake's current playing word
  *  @param letter_index Word's letter index to start printing the word letters
+ *  @param redraw Whether the whole snake's part of the screen must be redrawn
+ */
+void print_snake(Game* game, Word word, unsigned int letter_index,
+		int redraw);
+
+/**
+ *  @brief Targets the next letter to be eaten by the snake
+ *
+ *  Stops the pulse of the previous letter and starts pulsing the word's
+ *  letter at "letter_index" on the snake's side of the screen.
+ *
+ *  @param game Game's struct
+ *  @param word Snake's current playing word
+ *  @param letter_index Index of the next letter to be eaten
+ */
+void target_letter(Game* game, Word word, unsigned int letter_index);
+
+/**
+ *  @brief Prints game's snake motion between two moves
+ *
+ *  The snake moves one block every SNAKE_TICKS_PER_MOVE timer interrupts, but
+ *  its motion is drawn at every interrupt: the head gradually enters its new
+ *  block and the tail gradually leaves its old one, while the animated head
+ *  follows its front. Only the blocks involved are drawn and presented.
+ *
+ *  @param game Game's struct
+ *  @param phase Timer interrupts elapsed since the last move
  */
-void print_snake(Game* game, Word word, unsigned int letter_index);
+void print_snake_motion(Game* game, unsigned int phase);
 
 /**
  *  @brief Updates game's snake position on the screen
  *
  *	Updates snake's position on the screen, after the received keyboard scancode.
  *	As it only appears on the screen while playing, the snake is only able to move
- *	inside its left part of the screen.
+ *	inside its left part of the screen. The tail's block becomes the new
+ *	head's, so the cost doesn't depend on the snake's length.
  *
+ *  @param snake Game's snake
  *  @param scancode Scancode to update snake's moving direction
  */
-void update_snake(unsigned long scancode);
+void update_snake(Snake* snake, unsigned long scancode);
 
 /**
  *  @brief Tests snake's collision
  *
  *	Tests any collision with the snake, right after updating its position on
  *	the screen. Collision may be detected against the game predefined borders,
- *	the snake body itself or against any letter printed on the screen.
+ *	the snake body itself or against any letter printed on the screen. The
+ *	body is tested by looking up the head's cell in the snake's cells, and
+ *	letters by looking it up in the word's letters.
  *
  *  @param snake Game's snake
  *  @param word Word to test collision with
+ *  @param letters Word's snake letters, by cell
  *  @param letter_index Letter's index the snake is supposed to collide with
  *  @return Returns 0 on non-collision, 1 on collision with the wrong letter or with
  *  the snake's body itself, 2 if collision with the right letter occurs.
  */
-int test_collision_snake(Snake* snake, Word word, int letter_index);
+int test_collision_snake(Snake* snake, Word word, LetterIndex* letters,
+		int letter_index);
 
 /**
  *  @brief Game's main menu
@@ -439,6 +611,24 @@ int main_menu(Game* game);
  */
 int play_game(Game* game);
 
+/**
+ *  @brief Plays a screen transition
+ *
+ * 	Plays a transition between the screens previously stored in the game's
+ * 	transition surfaces, advancing it one frame per timer interrupt. Once it
+ * 	ends, the current screen is kept for "hold_ticks" timer interrupts. Any
+ * 	keyboard or mouse bytes received meanwhile are discarded. If the
+ * 	transitions couldn't be allocated, the screen cuts to the new one.
+ *
+ *	@param game Pointer to game's struct
+ *	@param type Transition's type
+ *	@param n_frames Transition's number of frames
+ *	@param hold_ticks Number of timer interrupts to wait after the transition
+ *	@return Returns 0 on success and non 0 otherwise
+ */
+int play_transition(Game* game, transition_type_t type, unsigned int n_frames,
+		unsigned int hold_ticks);
+
 /**
  *  @brief Function to write the winner to file
  *
@@ -455,12 +645,13 @@ int write_winner(int winner);
  *
  * 	After the game ends, this function is responsible for printing the respective
  * 	winner screen, being the winner passed a char* parameter (it may only be
- * 	"snake" or "cursor").
+ * 	"snake" or "cursor"). The screen crossfades from the playing field into the
+ * 	victory screen and, after VICTORY_TICKS, wipes into the menu.
  *
- * 	@param Menu Game's menu
+ * 	@param game Pointer to game's struct
  * 	@param winner Game's winner ("snake" or "cursor")
  */
-void victory_screen(Menu* menu, char* winner);
+void victory_screen(Game* game, char* winner);
 
 /**@}*/
 
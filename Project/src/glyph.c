@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <string.h>
+#include "glyph.h"
+
+#define GLYPH_NIBBLE_BYTES	(4 * SURFACE_BYTES_PER_PIXEL)	/**< Bytes of a nibble's pixels */
+
+/** Returns the squared distance between two RGB colors */
+static unsigned int glyph_distance(uint32_t a, uint32_t b) {
+
+	unsigned int distance = 0;
+	int shift;
+	for (shift = 0; shift < 24; shift += 8) {
+		int delta = (int) ((a >> shift) & 0xff) - (int) ((b >> shift) & 0xff);
+		distance += delta * delta;
+	}
+
+	return distance;
+}
+
+/** Hashes a color, mixing its high bits into the low ones a table is indexed by */
+static uint32_t glyph_hash(uint32_t color) {
+
+	uint32_t hash = color * 2654435761u;
+	return hash ^ (hash >> 16);
+}
+
+/** Picks the font's two most common colors, ignoring the tiles' outermost ring.
+ * Every distinct color is counted, in a table of colors, 1 if it doesn't fit */
+static int glyph_colors(const Surface* image, unsigned int n_glyphs,
+		uint32_t* ink, uint32_t* paper) {
+
+	/* at most half full, so probe sequences stay short */
+	unsigned int n_pixels = n_glyphs * (GLYPH_SIZE - 2) * (GLYPH_SIZE - 2);
+	unsigned int n_slots = 16;
+	while (n_slots < 2 * n_pixels)
+		n_slots *= 2;
+
+	/* slots hold a color and its count, free while the count is 0 */
+	uint32_t* colors = (uint32_t *) malloc(n_slots * sizeof(uint32_t));
+	unsigned int* counts = (unsigned int *) calloc(n_slots, sizeof(unsigned int));
+	if (colors == NULL || counts == NULL) {
+		free(colors);
+		free(counts);
+		return 1;
+	}
+
+	unsigned int tiles_x = image->width / GLYPH_SIZE, i, slot;
+	int x, y;
+	for (i = 0; i < n_glyphs; i++) {
+		int tile_x = (i % tiles_x) * GLYPH_SIZE, tile_y = (i / tiles_x) * GLYPH_SIZE;
+		for (y = 1; y < GLYPH_SIZE - 1; y++) {
+			for (x = 1; x < GLYPH_SIZE - 1; x++) {
+				uint32_t color = surface_get_pixel(image, tile_x + x, tile_y + y);
+				slot = glyph_hash(color) & (n_slots - 1);
+				while (counts[slot] != 0 && colors[slot] != color)
+					slot = (slot + 1) & (n_slots - 1);
+				colors[slot] = color;
+				counts[slot]++;
+			}
+		}
+	}
+
+	unsigned int first = n_slots, second = n_slots;
+	for (slot = 0; slot < n_slots; slot++) {
+		if (counts[slot] == 0)
+			continue;
+		if (first == n_slots || counts[slot] > counts[first]) {
+			second = first;
+			first = slot;
+		} else if (second == n_slots || counts[slot] > counts[second])
+			second = slot;
+	}
+
+	*paper = first != n_slots ? colors[first] : 0;
+	*ink = second != n_slots ? colors[second] : *paper;
+
+	free(colors);
+	free(counts);
+	return 0;
+}
+
+GlyphSet* glyph_compile(const Surface* image) {
+
+	unsigned int tiles_x = image->width / GLYPH_SIZE;
+	unsigned int n_glyphs = tiles_x * (image->height / GLYPH_SIZE);
+	if (n_glyphs == 0)
+		return NULL;
+
+	/* the masks follow the set, in the same allocation */
+	GlyphSet* glyphs = (GlyphSet *) malloc(sizeof(GlyphSet) + n_glyphs * sizeof(GlyphMask));
+	if (glyphs == NULL)
+		return NULL;
+
+	glyphs->n_glyphs = n_glyphs;
+	glyphs->masks = (GlyphMask *) (glyphs + 1);
+	if (glyph_colors(image, n_glyphs, &glyphs->ink, &glyphs->paper) != 0) {
+		free(glyphs);
+		return NULL;
+	}
+
+	unsigned int i;
+	int x, y;
+	for (i = 0; i < n_glyphs; i++) {
+		int tile_x = (i % tiles_x) * GLYPH_SIZE, tile_y = (i / tiles_x) * GLYPH_SIZE;
+		for (y = 0; y < GLYPH_SIZE; y++) {
+			uint16_t row = 0;
+			for (x = 0; x < GLYPH_SIZE; x++) {
+				uint32_t color = surface_get_pixel(image, tile_x + x, tile_y + y);
+				if (glyph_distance(color, glyphs->ink) < glyph_distance(color, glyphs->paper))
+					row |= 1 << (GLYPH_SIZE - 1 - x);
+			}
+			glyphs->masks[i].rows[y] = row;
+		}
+	}
+
+	return glyphs;
+}
+
+void glyph_destroy(GlyphSet* glyphs) {
+
+	free(glyphs);
+}
+
+const GlyphMask* glyph_mask(const GlyphSet* glyphs, int glyph) {
+
+	if (glyphs == NULL || glyph < 0 || (unsigned int) glyph >= glyphs->n_glyphs)
+		return NULL;
+
+	return &glyphs->masks[glyph];
+}
+
+int glyph_covered(const GlyphMask* mask, int x, int y) {
+
+	return (mask->rows[y] >> (GLYPH_SIZE - 1 - x)) & 1;
+}
+
+/** Draws a glyph crossing the surface's edges, pixel by pixel */
+static void glyph_blit_clipped(Surface* dst, const GlyphMask* mask, uint32_t ink,
+		uint32_t paper, int keyed, int dst_x, int dst_y) {
+
+	int x, y;
+	for (y = 0; y < GLYPH_SIZE; y++) {
+		if (dst_y + y < 0 || dst_y + y >= dst->height)
+			continue;
+		for (x = 0; x < GLYPH_SIZE; x++) {
+			if (dst_x + x < 0 || dst_x + x >= dst->width)
+				continue;
+			if (glyph_covered(mask, x, y))
+				surface_put_pixel(dst, dst_x + x, dst_y + y, ink);
+			else if (!keyed)
+				surface_put_pixel(dst, dst_x + x, dst_y + y, paper);
+		}
+	}
+}
+
+/** Returns whether a glyph lies entirely inside a surface */
+static int glyph_inside(const Surface* dst, int dst_x, int dst_y) {
+
+	return dst_x >= 0 && dst_y >= 0 && dst_x + GLYPH_SIZE <= dst->width
+			&& dst_y + GLYPH_SIZE <= dst->height;
+}
+
+/** Stores an RGB color as a native pixel */
+static void glyph_pixel(uint8_t* pixel, uint32_t color) {
+
+	pixel[0] = color & 0xff;
+	pixel[1] = (color >> 8) & 0xff;
+	pixel[2] = (color >> 16) & 0xff;
+}
+
+void glyph_blit(Surface* dst, const GlyphMask* mask, uint32_t ink, uint32_t paper,
+		int dst_x, int dst_y) {
+
+	if (!glyph_inside(dst, dst_x, dst_y)) {
+		glyph_blit_clipped(dst, mask, ink, paper, 0, dst_x, dst_y);
+		return;
+	}
+
+	/* each nibble's four pixels, leftmost on the nibble's highest bit */
+	uint8_t expand[16][GLYPH_NIBBLE_BYTES];
+	unsigned int nibble;
+	int i;
+	for (nibble = 0; nibble < 16; nibble++)
+		for (i = 0; i < 4; i++)
+			glyph_pixel(&expand[nibble][i * SURFACE_BYTES_PER_PIXEL],
+					(nibble >> (3 - i)) & 1 ? ink : paper);
+
+	int x, y;
+	for (y = 0; y < GLYPH_SIZE; y++) {
+		char* row = dst->pixels + (dst_y + y) * dst->pitch
+				+ dst_x * SURFACE_BYTES_PER_PIXEL;
+		unsigned int bits = mask->rows[y];
+		for (x = 0; x < GLYPH_SIZE; x += 4, row += GLYPH_NIBBLE_BYTES)
+			memcpy(row, expand[(bits >> (GLYPH_SIZE - 4 - x)) & 0xf], GLYPH_NIBBLE_BYTES);
+	}
+}
+
+void glyph_blit_keyed(Surface* dst, const GlyphMask* mask, uint32_t ink,
+		int dst_x, int dst_y) {
+
+	if (!glyph_inside(dst, dst_x, dst_y)) {
+		glyph_blit_clipped(dst, mask, ink, 0, 1, dst_x, dst_y);
+		return;
+	}
+
+	uint8_t color[SURFACE_BYTES_PER_PIXEL];
+	glyph_pixel(color, ink);
+
+	int y;
+	for (y = 0; y < GLYPH_SIZE; y++) {
+		char* row = dst->pixels + (dst_y + y) * dst->pitch
+				+ dst_x * SURFACE_BYTES_PER_PIXEL;
+
+		/* visits the set bits only, lowest first */
+		unsigned int bits = mask->rows[y];
+		while (bits != 0) {
+			int x = GLYPH_SIZE - 1 - __builtin_ctz(bits);
+			memcpy(row + x * SURFACE_BYTES_PER_PIXEL, color, SURFACE_BYTES_PER_PIXEL);
+			bits &= bits - 1;
+		}
+	}
+}
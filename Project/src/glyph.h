@@ -0,0 +1,112 @@
+#ifndef __GLYPH_H
+#define __GLYPH_H
+
+#include <stdint.h>
+#include "surface.h"
+
+/**
+ * @file glyph.h
+ */
+
+/**
+ *	@defgroup Glyph
+ *	@{
+ *
+ *	Two-tone font glyphs stored as 1-bit coverage masks, 32 bytes per glyph,
+ *	plus the font's ink and paper colors. Glyphs are expanded into native
+ *	pixels as they're drawn, so they may be drawn in any colors
+ */
+
+#define GLYPH_SIZE		16		/**< Glyphs' width and height */
+
+/**
+ * @brief Glyph's coverage mask
+*/
+typedef struct GlyphMask {
+	uint16_t rows[GLYPH_SIZE];	/**< One row per element, leftmost pixel on the highest bit */
+} GlyphMask;
+
+/**
+ * @brief Font's glyphs and colors
+*/
+typedef struct GlyphSet {
+	unsigned int n_glyphs;		/**< Number of glyphs */
+	uint32_t ink;				/**< Color of the covered pixels */
+	uint32_t paper;				/**< Color of the uncovered pixels */
+	GlyphMask* masks;			/**< Glyphs' masks */
+} GlyphSet;
+
+/**
+ *  @brief Compiles a font's image into glyph masks
+ *
+ * 	The image is cut into GLYPH_SIZE tiles, read left to right, top to
+ * 	bottom. Its most common color is the paper, the second most common the
+ * 	ink, each ignoring the tiles' outermost ring, where frames are drawn.
+ * 	A pixel is covered if it's closer to the ink than to the paper.
+ *
+ *	@param image Font's image
+ *	@return Returns pointer to the glyphs, NULL on failure
+ */
+GlyphSet* glyph_compile(const Surface* image);
+
+/**
+ *  @brief Glyphs destroyer
+ *
+ *	@param glyphs Glyphs to be destroyed
+ */
+void glyph_destroy(GlyphSet* glyphs);
+
+/**
+ *  @brief Returns a glyph's mask
+ *
+ *	@param glyphs Font's glyphs
+ *	@param glyph Glyph's index
+ *	@return Returns pointer to the mask, NULL for an invalid index
+ */
+const GlyphMask* glyph_mask(const GlyphSet* glyphs, int glyph);
+
+/**
+ *  @brief Returns whether a glyph's pixel is covered
+ *
+ *	@param mask Glyph's mask
+ *	@param x Pixel's x coordinate in the glyph
+ *	@param y Pixel's y coordinate in the glyph
+ *	@return Returns 1 if the pixel is covered, 0 otherwise
+ */
+int glyph_covered(const GlyphMask* mask, int x, int y);
+
+/**
+ *  @brief Draws a glyph on a surface
+ *
+ * 	Covered pixels are drawn in the ink color, the others in the paper
+ * 	color. Mask bits are expanded four at a time through a table of
+ * 	ready-made pixels, built for the given colors.
+ *
+ *	@param dst Surface to draw on
+ *	@param mask Glyph's mask
+ *	@param ink Covered pixels' RGB color
+ *	@param paper Uncovered pixels' RGB color
+ *	@param dst_x Glyph's left-upper corner x coordinate
+ *	@param dst_y Glyph's left-upper corner y coordinate
+ */
+void glyph_blit(Surface* dst, const GlyphMask* mask, uint32_t ink, uint32_t paper,
+		int dst_x, int dst_y);
+
+/**
+ *  @brief Draws a glyph's covered pixels on a surface
+ *
+ * 	Same as glyph_blit(), but uncovered pixels are left untouched. Only the
+ * 	mask's set bits are visited.
+ *
+ *	@param dst Surface to draw on
+ *	@param mask Glyph's mask
+ *	@param ink Covered pixels' RGB color
+ *	@param dst_x Glyph's left-upper corner x coordinate
+ *	@param dst_y Glyph's left-upper corner y coordinate
+ */
+void glyph_blit_keyed(Surface* dst, const GlyphMask* mask, uint32_t ink,
+		int dst_x, int dst_y);
+
+/**@}*/
+
+#endif /* __GLYPH_H */
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "governor.h"
+#include "cycles.h"
+
+void governor_init(Governor* governor, uint64_t budget) {
+
+	governor->last_tick = 0;
+	governor->budget = budget;
+	governor->next_tick = 0;
+	governor->n_samples = 0;
+	governor->render_cycles = 0;
+	governor->over_budget = 0;
+	governor->skipped_frames = 0;
+	governor->late_ticks = 0;
+}
+
+/** Returns the mean of the middle half of the periods measured while
+ * calibrating, leaving out late and bunched interrupts at either end */
+static uint64_t governor_calibrate(Governor* governor) {
+
+	/* insertion sort, there are only a few of them */
+	unsigned int i, j;
+	for (i = 1; i < governor->n_samples; i++) {
+		uint64_t sample = governor->samples[i];
+		for (j = i; j > 0 && governor->samples[j - 1] > sample; j--)
+			governor->samples[j] = governor->samples[j - 1];
+		governor->samples[j] = sample;
+	}
+
+	uint64_t sum = 0;
+	unsigned int first = governor->n_samples / 4, last = governor->n_samples - first;
+	for (i = first; i < last; i++)
+		sum += governor->samples[i];
+
+	return sum / (last - first);
+}
+
+unsigned int governor_tick(Governor* governor) {
+
+	uint64_t now = cycles_read();
+	unsigned int ticks = 1;
+
+	if (governor->budget == 0) {
+		/* every interrupt is a tick until the period is calibrated, from
+		 * several, so a few late or bunched ones don't skew it */
+		if (governor->last_tick != 0)
+			governor->samples[governor->n_samples++] = now - governor->last_tick;
+		if (governor->n_samples == GOVERNOR_CALIBRATION) {
+			governor->budget = governor_calibrate(governor);
+			governor->next_tick = now + governor->budget;
+		}
+	} else if (governor->next_tick == 0) {
+		governor->next_tick = now + governor->budget;
+	} else {
+		/* one tick per deadline passed, half a period early at most, so
+		 * ticks caught up never outrun the time really elapsed */
+		ticks = 0;
+		while (now + governor->budget / 2 >= governor->next_tick
+				&& ticks < GOVERNOR_MAX_CATCHUP) {
+			governor->next_tick += governor->budget;
+			ticks++;
+		}
+
+		/* interrupts missed beyond the catch-up are dropped */
+		if (now + governor->budget / 2 >= governor->next_tick)
+			governor->next_tick = now + governor->budget;
+		if (ticks > 1)
+			governor->late_ticks += ticks - 1;
+	}
+
+	/* renders of the last tick decide the fate of the next cosmetic frames */
+	governor->over_budget = governor->budget != 0 && governor->render_cycles
+			> governor->budget * GOVERNOR_RENDER_SHARE / 100;
+
+	governor->render_cycles = 0;
+	governor->last_tick = now;
+	return ticks;
+}
+
+void governor_render_begin(Governor* governor) {
+
+	governor->render_start = cycles_read();
+}
+
+void governor_render_end(Governor* governor) {
+
+	governor->render_cycles += cycles_read() - governor->render_start;
+}
+
+int governor_allow_frame(Governor* governor) {
+
+	if (governor->over_budget) {
+		governor->skipped_frames++;
+		return 0;
+	}
+
+	return 1;
+}
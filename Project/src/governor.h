@@ -0,0 +1,94 @@
+#ifndef __GOVERNOR_H
+#define __GOVERNOR_H
+
+#include <stdint.h>
+
+/**
+ * @file governor.h
+ */
+
+/**
+ *	@defgroup Governor
+ *	@{
+ *
+ *	Frame-budget governor, measuring the time spent rendering against the
+ *	timer interrupt's period and deciding which cosmetic frames to skip
+ */
+
+#define GOVERNOR_RENDER_SHARE	75	/**< Percentage of a tick rendering may use */
+#define GOVERNOR_MAX_CATCHUP	4	/**< Maximum number of ticks caught up at once */
+#define GOVERNOR_CALIBRATION	31	/**< Periods measured when the budget isn't known, half a second */
+
+/**
+ * @brief Frame-budget governor
+*/
+typedef struct Governor {
+	uint64_t last_tick;				/**< Time stamp of the last timer interrupt */
+	uint64_t budget;				/**< Timer interrupt's period in cycles, 0 until calibrated */
+	uint64_t next_tick;				/**< Time stamp the next tick is due at */
+	uint64_t render_start;			/**< Time stamp of the current render's start */
+	uint64_t render_cycles;			/**< Cycles spent rendering since the last tick */
+	int over_budget;				/**< Whether the last tick's renders went over budget */
+	unsigned long skipped_frames;	/**< Number of cosmetic frames skipped */
+	unsigned long late_ticks;		/**< Number of timer interrupts handled late */
+	uint64_t samples[GOVERNOR_CALIBRATION];	/**< Periods measured while calibrating */
+	unsigned int n_samples;			/**< Number of periods measured */
+} Governor;
+
+/**
+ *  @brief Governor initializer
+ *
+ * 	Resets the governor's counters. The budget is the timer interrupt's
+ * 	period, known from the timer's frequency and the counter's rate. If
+ * 	the rate isn't known yet, the budget is the mean of the middle half of
+ * 	the next GOVERNOR_CALIBRATION periods measured, which late and bunched
+ * 	interrupts don't reach. Either way it's then fixed.
+ *
+ *	@param governor Governor to be initialized
+ *	@param budget Timer interrupt's period in cycles, 0 to calibrate it
+ */
+void governor_init(Governor* governor, uint64_t budget);
+
+/**
+ *  @brief Registers a timer interrupt
+ *
+ * 	Counts the tick deadlines passed since the last timer interrupt, once
+ * 	the budget is known. Until then every interrupt is a tick.
+ * 	Interrupts missed while the game was busy are caught up, and counted
+ * 	as late ticks, but never past the time really elapsed: an interrupt
+ * 	arriving early after a catch-up counts no tick.
+ *
+ *	@param governor Governor to be updated
+ *	@return Returns the number of timer ticks elapsed since the last one,
+ *	which the game logic must process (may be 0)
+ */
+unsigned int governor_tick(Governor* governor);
+
+/**
+ *  @brief Marks the beginning of a render
+ *
+ *	@param governor Governor to be updated
+ */
+void governor_render_begin(Governor* governor);
+
+/**
+ *  @brief Marks the end of a render
+ *
+ *	@param governor Governor to be updated
+ */
+void governor_render_end(Governor* governor);
+
+/**
+ *  @brief Decides whether a cosmetic frame should be presented
+ *
+ * 	Cosmetic frames are skipped while rendering goes over its share of the
+ * 	tick's budget. Skipped frames are counted.
+ *
+ *	@param governor Governor to be consulted
+ *	@return Returns 1 if the frame should be presented and 0 otherwise
+ */
+int governor_allow_frame(Governor* governor);
+
+/**@}*/
+
+#endif /* __GOVERNOR_H */
@@ -27,6 +27,7 @@
 
 #define ESC_KEY			0x81
 #define WAIT_KBC		2000
+#define KBC_RETRIES		10		/**< @brief Attempts at a KBC access before giving up */
 
 /* KBC Command Bytes */
 #define READ_CMD		0x20	/**< @brief KBC read command */
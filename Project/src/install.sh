@@ -2,5 +2,15 @@ cd ..
 cp conf/proj /etc/system.conf.d
 mkdir /home/snaktionary
 cp -vr res/ /home/snaktionary
+cd tools/assetc
+make
+./assetc /home/snaktionary/res/*.png
+cd ../dictc
+make
+./dictc /home/snaktionary/res/words.txt /home/snaktionary/res/words.dict
+cd ../snkpack
+make
+./snkpack /home/snaktionary/res/snaktionary.pack /home/snaktionary/res/*.png /home/snaktionary/res/words.dict
+cd ../..
 chmod 777 src/compile.sh
 chmod 777 src/run.sh
\ No newline at end of file
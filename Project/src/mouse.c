@@ -4,6 +4,8 @@
 #include "kbd.h"
 #include "mouse.h"
 
+static unsigned long retries = 0;	/**< Number of KBC retries */
+
 int mouse_subscribe_int(int* g_hookid_mouse) {
 
 	// setting KBC interruption request policy
@@ -41,48 +43,67 @@ int mouse_unsubscribe_int(int* g_hookid_mouse) {
 int write_cmd(unsigned long port, unsigned long cmd) {
 
 	unsigned long status;
-	/* executed while the command is not written */
-	while (1) {
+	unsigned int tries;
+	/* executed while the command is not written, a few times at most */
+	for (tries = 0; tries < KBC_RETRIES; tries++) {
 		/* reads status from Status Register */
-		readStatusRegister(&status);
-		/* if Input Buffer is not full*/
-		if ((status & IBF) == 0)
-		{
-			/* write command */
+		if (readStatusRegister(&status) == 0 && (status & IBF) == 0) {
+			/* Input Buffer is not full: write command */
 			if (sys_outb(port, cmd) != OK) {
 				printf("Error writing the command %x to port 0x%x!\n", cmd, port);
 				return 1;
 			}
-			break;
+			return 0;
 		}
 
+		retries++;
 		tickdelay(micros_to_ticks(WAIT_KBC));
 	}
 
-	return 0;
+	printf("KBC's input buffer never emptied!\n");
+	return 1;
+}
+
+/** Reads the mouse's response once the Output Buffer is full, 1 if it never fills */
+static int read_response(unsigned long* response) {
+
+	unsigned long status;
+	unsigned int tries;
+	for (tries = 0; tries < KBC_RETRIES; tries++) {
+		if (readStatusRegister(&status) == 0 && (status & OBF))
+			return readOutBuffer(response);
+
+		retries++;
+		tickdelay(micros_to_ticks(WAIT_KBC));
+	}
+
+	return 1;
 }
 
 int mouse_write_cmd(unsigned long cmd) {
 
 	unsigned long response;
-	/* executed while the command is not written */
-	while (1) {
-		/* write command 0xD4 to STATUS_REG */
-		if (!write_cmd(STAT_REG, MOUSE_CMD)) {
-			/* write command to IN_BUF */
-			if (!write_cmd(IN_BUF, cmd)) {
-				/* wait for device's response */
-				tickdelay(micros_to_ticks(WAIT_KBC));
-				sys_inb(OUT_BUF, &response);
-				/* if it is a non-error response, no need to
-				 * resend the command */
-				if (response != NACK || response != ERROR) {
-					break;
-				}
-			}
+	unsigned int tries;
+	/* executed while the command is refused, a few times at most */
+	for (tries = 0; tries < KBC_RETRIES; tries++) {
+		/* write command 0xD4 to STATUS_REG, then command to IN_BUF */
+		if (!write_cmd(STAT_REG, MOUSE_CMD) && !write_cmd(IN_BUF, cmd)
+				&& !read_response(&response)) {
+			/* if it is a non-error response, no need to
+			 * resend the command */
+			if (response != NACK && response != ERROR)
+				return 0;
 		}
+
+		retries++;
 		tickdelay(micros_to_ticks(WAIT_KBC));
 	}
 
-	return 0;
+	printf("Mouse refused the command %x!\n", cmd);
+	return 1;
+}
+
+unsigned long kbc_retries() {
+
+	return retries;
 }
@@ -25,6 +25,8 @@ int mouse_unsubscribe_int(int* g_hookid_mouse);
 
 /**
  *	@brief Writes command "cmd" to port "port"
+ *
+ *	Waits for the KBC's input buffer to empty, KBC_RETRIES times at most.
  *	@param port Port to send the command to
  *	@param cmd Command to be written to port
  *	@return Returns 0 upon success and 1 otherwise
@@ -33,11 +35,23 @@ int write_cmd(unsigned long port, unsigned long cmd);
 
 /**
  *	@brief Sends a mouse command to the KBC
+ *
+ *	Resends the command while the mouse refuses it or doesn't answer,
+ *	KBC_RETRIES times at most.
  *	@param cmd Command to be written to the KBC
  *	@return Returns 0 upon success and non-zero otherwise
  */
 int mouse_write_cmd(unsigned long cmd);
 
+/**
+ *	@brief Counts the KBC's retries
+ *
+ *	Each tickdelay() waiting for one of the KBC's buffers, or resending a
+ *	command the mouse refused, counts as a retry.
+ *	@return Returns the number of retries since the program started
+ */
+unsigned long kbc_retries();
+
 /**@}*/
 
 #endif /* __MOUSE_H */
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "pack.h"
+
+static char* pack = NULL;					/**< Pack's contents */
+static const PackHeader* header = NULL;		/**< Pack's header */
+static const PackEntry* entries = NULL;		/**< Pack's index */
+static uint8_t* verified = NULL;			/**< Whether each entry's checksum matched */
+
+uint32_t pack_checksum(const void* data, size_t size) {
+
+	const unsigned char* bytes = (const unsigned char *) data;
+	uint32_t hash = 2166136261UL;
+
+	size_t i;
+	for (i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619UL;
+	}
+
+	return hash;
+}
+
+int pack_open(const char* path) {
+
+	struct stat info;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return 1;
+
+	if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(PackHeader)) {
+		close(fd);
+		return 1;
+	}
+
+	pack = (char *) malloc(info.st_size);
+	if (pack == NULL) {
+		close(fd);
+		return 1;
+	}
+
+	/* the whole pack in a single read */
+	if (read(fd, pack, info.st_size) != info.st_size) {
+		printf("Asset pack \"%s\" couldn't be read!\n", path);
+		pack_close();
+		close(fd);
+		return 1;
+	}
+	close(fd);
+
+	header = (const PackHeader *) pack;
+	entries = (const PackEntry *) (header + 1);
+
+	if (header->magic != PACK_MAGIC || header->version != PACK_VERSION
+			|| header->size != (uint32_t) info.st_size
+			|| header->n_entries > (info.st_size - sizeof(PackHeader)) / sizeof(PackEntry)) {
+		printf("Asset pack \"%s\" is corrupt!\n", path);
+		pack_close();
+		return 1;
+	}
+
+	/* entries must lie inside the pack */
+	size_t i;
+	for (i = 0; i < header->n_entries; i++) {
+		if (entries[i].offset > header->size
+				|| entries[i].size > header->size - entries[i].offset) {
+			printf("Asset pack \"%s\" is corrupt!\n", path);
+			pack_close();
+			return 1;
+		}
+	}
+
+	verified = (uint8_t *) malloc(header->n_entries + 1);
+	if (verified == NULL) {
+		pack_close();
+		return 1;
+	}
+
+	/* checksums are verified once, corrupt entries are left out of lookups */
+	for (i = 0; i < header->n_entries; i++) {
+		verified[i] = pack_checksum(pack + entries[i].offset, entries[i].size)
+				== entries[i].checksum;
+		if (!verified[i])
+			printf("Asset pack's entry \"%.*s\" is corrupt!\n", PACK_NAME_MAX,
+					entries[i].name);
+	}
+
+	return 0;
+}
+
+void pack_close() {
+
+	free(pack);
+	free(verified);
+	pack = NULL;
+	verified = NULL;
+	header = NULL;
+	entries = NULL;
+}
+
+int pack_contains(const char* name) {
+
+	if (pack == NULL)
+		return 0;
+
+	size_t i;
+	for (i = 0; i < header->n_entries; i++)
+		if (verified[i] && strncmp(entries[i].name, name, PACK_NAME_MAX) == 0)
+			return 1;
+
+	return 0;
+}
+
+const void* pack_get(const char* name, pack_format_t format, size_t* size) {
+
+	if (pack == NULL)
+		return NULL;
+
+	size_t i;
+	for (i = 0; i < header->n_entries; i++) {
+		const PackEntry* entry = &entries[i];
+		if (!verified[i] || strncmp(entry->name, name, PACK_NAME_MAX) != 0
+				|| entry->format != (uint32_t) format)
+			continue;
+
+		*size = entry->size;
+		return pack + entry->offset;
+	}
+
+	return NULL;
+}
@@ -0,0 +1,102 @@
+#ifndef __PACK_H
+#define __PACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file pack.h
+ */
+
+/**
+ *	@defgroup Pack
+ *	@{
+ *
+ *	Asset pack: a single file holding every resource, with an index at its
+ *	start. The pack is read into memory once at startup and entries are
+ *	accessed in place, without being copied
+ */
+
+#define PACK_MAGIC		0x4b504e53	/**< Pack's magic number ("SNPK") */
+#define PACK_VERSION	1			/**< Pack format's version */
+#define PACK_NAME_MAX	32			/**< Maximum length of an entry's name */
+#define PACK_ALIGNMENT	4			/**< Alignment of every entry's data */
+
+/**
+ * @brief Formats of the pack's entries
+*/
+typedef enum { PACK_DATA, PACK_IMAGE, PACK_INDEXED, PACK_PATCH } pack_format_t;
+
+/**
+ * @brief Pack's header, followed by the index's entries
+*/
+typedef struct PackHeader {
+	uint32_t magic;			/**< Must be PACK_MAGIC */
+	uint32_t version;		/**< Must be PACK_VERSION */
+	uint32_t n_entries;		/**< Number of entries in the index */
+	uint32_t size;			/**< Pack's size in bytes */
+} PackHeader;
+
+/**
+ * @brief Pack's index entry
+*/
+typedef struct PackEntry {
+	char name[PACK_NAME_MAX];	/**< Entry's name, the file name it was built from */
+	uint32_t offset;			/**< Offset of the entry's data from the pack's start */
+	uint32_t size;				/**< Size of the entry's data */
+	uint32_t format;			/**< Entry's format, a pack_format_t */
+	uint32_t checksum;			/**< Checksum of the entry's data */
+} PackEntry;
+
+/**
+ *  @brief Computes the checksum of a pack's entry (32-bit FNV-1a)
+ *
+ *	@param data Entry's data
+ *	@param size Data's size
+ *	@return Returns the data's checksum
+ */
+uint32_t pack_checksum(const void* data, size_t size);
+
+/**
+ *  @brief Opens the asset pack
+ *
+ * 	Reads the whole pack into memory, validates its index and verifies
+ * 	every entry's checksum once. Corrupt entries are reported and left
+ * 	out of every lookup, as if they were missing.
+ *
+ *	@param path Pack's path
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int pack_open(const char* path);
+
+/**
+ *  @brief Closes the asset pack
+ *
+ * 	Data returned by pack_get() becomes invalid.
+ */
+void pack_close();
+
+/**
+ *  @brief Tests whether the asset pack has a valid entry, of any format
+ *
+ *	@param name Entry's name
+ *	@return Returns 1 if the entry exists, 0 otherwise or without pack
+ */
+int pack_contains(const char* name);
+
+/**
+ *  @brief Accesses an entry of the asset pack
+ *
+ * 	Returns the entry's data in place, its checksum having been verified
+ * 	when the pack was opened. Entries of other formats are ignored.
+ *
+ *	@param name Entry's name
+ *	@param format Entry's format
+ *	@param size Returns the entry's size
+ *	@return Returns pointer to the entry's data, NULL if missing or corrupt
+ */
+const void* pack_get(const char* name, pack_format_t format, size_t* size);
+
+/**@}*/
+
+#endif /* __PACK_H */
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "parallel.h"
+
+#ifdef __minix
+
+unsigned int parallel_workers() {
+
+	return 1;
+}
+
+void parallel_run(unsigned int n_tasks, parallel_task_t task, void* context) {
+
+	unsigned int i;
+	for (i = 0; i < n_tasks; i++)
+		task(context, i);
+}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief Tasks shared by the workers
+*/
+typedef struct Work {
+	pthread_mutex_t lock;		/**< Guards the next task's index */
+	unsigned int next;			/**< Next task to be taken */
+	unsigned int n_tasks;		/**< Number of tasks */
+	parallel_task_t task;		/**< Task run for each index */
+	void* context;				/**< Task's context */
+} Work;
+
+/** Takes tasks until there are none left */
+static void* parallel_worker(void* arg) {
+
+	Work* work = (Work *) arg;
+
+	for (;;) {
+		pthread_mutex_lock(&work->lock);
+		unsigned int i = work->next;
+		if (i < work->n_tasks)
+			work->next++;
+		pthread_mutex_unlock(&work->lock);
+
+		if (i >= work->n_tasks)
+			return NULL;
+		work->task(work->context, i);
+	}
+}
+
+unsigned int parallel_workers() {
+
+	long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (n_cpus < 1)
+		return 1;
+	return n_cpus < PARALLEL_MAX_WORKERS ? n_cpus : PARALLEL_MAX_WORKERS;
+}
+
+void parallel_run(unsigned int n_tasks, parallel_task_t task, void* context) {
+
+	Work work;
+	pthread_mutex_init(&work.lock, NULL);
+	work.next = 0;
+	work.n_tasks = n_tasks;
+	work.task = task;
+	work.context = context;
+
+	/* the calling thread is a worker too */
+	pthread_t threads[PARALLEL_MAX_WORKERS];
+	unsigned int n_threads = parallel_workers(), i;
+	if (n_threads > n_tasks)
+		n_threads = n_tasks;
+
+	for (i = 1; i < n_threads; i++) {
+		if (pthread_create(&threads[i], NULL, parallel_worker, &work) != 0) {
+			printf("Couldn't start worker thread!\n");
+			break;
+		}
+	}
+	n_threads = i;
+
+	parallel_worker(&work);
+
+	/* every task is done once every worker is joined */
+	for (i = 1; i < n_threads; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&work.lock);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __PARALLEL_H
+#define __PARALLEL_H
+
+/**
+ * @file parallel.h
+ */
+
+/**
+ *	@defgroup Parallel
+ *	@{
+ *
+ *	Runs independent tasks on a small pool of worker threads, on host builds
+ *	with POSIX threads. MINIX has no threads: tasks run one after the other
+ *	on the calling thread
+ */
+
+#define PARALLEL_MAX_WORKERS	8	/**< Maximum number of worker threads */
+
+/**
+ * @brief Task run for each index
+*/
+typedef void (*parallel_task_t)(void* context, unsigned int index);
+
+/**
+ *  @brief Returns the number of threads tasks are run on
+ *
+ * 	One per online processor, up to PARALLEL_MAX_WORKERS. Always 1 on MINIX.
+ */
+unsigned int parallel_workers();
+
+/**
+ *  @brief Runs a task for every index, concurrently
+ *
+ * 	The calling thread runs tasks too, and only returns once every task
+ * 	is done, so their results may be used right away.
+ *
+ *	@param n_tasks Number of tasks, indexed from 0
+ *	@param task Task to run for each index
+ *	@param context Task's context
+ */
+void parallel_run(unsigned int n_tasks, parallel_task_t task, void* context);
+
+/**@}*/
+
+#endif /* __PARALLEL_H */
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "particles.h"
+#include "video_gr.h"
+
+ParticleSystem* initialize_particles() {
+
+	ParticleSystem* particles = (ParticleSystem *) malloc(sizeof(ParticleSystem));
+	if (particles == NULL)
+		return NULL;
+
+	size_t i;
+	for (i = 0; i < MAX_EMITTERS; i++) {
+		particles->emitters[i].under = surface_create(2 * EMITTER_RADIUS,
+				2 * EMITTER_RADIUS);
+		if (particles->emitters[i].under == NULL) {
+			while (i-- > 0)
+				surface_destroy(particles->emitters[i].under);
+			free(particles);
+			return NULL;
+		}
+	}
+
+	particles_clear(particles);
+	return particles;
+}
+
+void destroy_particles(ParticleSystem* particles) {
+
+	if (particles == NULL)
+		return;
+
+	size_t i;
+	for (i = 0; i < MAX_EMITTERS; i++)
+		surface_destroy(particles->emitters[i].under);
+	free(particles);
+}
+
+void particles_clear(ParticleSystem* particles) {
+
+	size_t i;
+	for (i = 0; i < MAX_EMITTERS; i++) {
+		particles->emitters[i].n_particles = 0;
+		particles->emitters[i].drawn = 0;
+		particles->emitters[i].dirty = 0;
+	}
+
+	particles->n_particles = 0;
+}
+
+unsigned int particles_emit(ParticleSystem* particles, int x, int y,
+		unsigned int n, int speed, int life, uint32_t color) {
+
+	/* an emitter is free once its area was erased and presented */
+	Emitter* emitter = NULL;
+	size_t e;
+	for (e = 0; e < MAX_EMITTERS; e++) {
+		emitter = &particles->emitters[e];
+		if (emitter->n_particles == 0 && !emitter->drawn && !emitter->dirty)
+			break;
+	}
+	if (e == MAX_EMITTERS)
+		return 0;
+
+	/* emitter's area, clipped to the screen */
+	int x0 = x - EMITTER_RADIUS, y0 = y - EMITTER_RADIUS;
+	int x1 = x + EMITTER_RADIUS, y1 = y + EMITTER_RADIUS;
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 > H_RES)
+		x1 = H_RES;
+	if (y1 > V_RES)
+		y1 = V_RES;
+
+	emitter->x = x0;
+	emitter->y = y0;
+	emitter->width = x1 - x0;
+	emitter->height = y1 - y0;
+	emitter->color[0] = color & 0xff;
+	emitter->color[1] = (color >> 8) & 0xff;
+	emitter->color[2] = (color >> 16) & 0xff;
+
+	if (n > MAX_PARTICLES - particles->n_particles)
+		n = MAX_PARTICLES - particles->n_particles;
+
+	int max_speed = speed << PARTICLE_SHIFT;
+	unsigned int i;
+	for (i = particles->n_particles; i < particles->n_particles + n; i++) {
+		particles->x[i] = x << PARTICLE_SHIFT;
+		particles->y[i] = y << PARTICLE_SHIFT;
+		particles->vx[i] = rand() % (2 * max_speed + 1) - max_speed;
+		particles->vy[i] = rand() % (2 * max_speed + 1) - max_speed;
+		particles->life[i] = life / 2 + rand() % (life / 2 + 1);
+		particles->emitter[i] = e;
+	}
+
+	particles->n_particles += n;
+	emitter->n_particles = n;
+	return n;
+}
+
+void particles_erase(ParticleSystem* particles) {
+
+	Surface* screen = vg_back_buffer();
+
+	size_t e;
+	for (e = 0; e < MAX_EMITTERS; e++) {
+		Emitter* emitter = &particles->emitters[e];
+		if (!emitter->drawn)
+			continue;
+
+		surface_blit(screen, emitter->under, 0, 0, emitter->width,
+				emitter->height, emitter->x, emitter->y);
+		emitter->drawn = 0;
+		emitter->dirty = 1;
+	}
+}
+
+void particles_update(ParticleSystem* particles, unsigned int ticks) {
+
+	unsigned int n = particles->n_particles;
+	int32_t dt = ticks;
+	unsigned int i;
+
+	if (n == 0)
+		return;
+
+	/* branchless over contiguous arrays, so the compiler may vectorize it */
+	for (i = 0; i < n; i++) {
+		particles->x[i] += particles->vx[i] * dt;
+		particles->y[i] += particles->vy[i] * dt;
+		particles->vy[i] += PARTICLE_GRAVITY * dt;
+		particles->life[i] -= dt;
+	}
+
+	/* dead particles are replaced by the last one, keeping the pool dense */
+	i = 0;
+	while (i < n) {
+		Emitter* emitter = &particles->emitters[particles->emitter[i]];
+		int x = particles->x[i] >> PARTICLE_SHIFT;
+		int y = particles->y[i] >> PARTICLE_SHIFT;
+
+		if (particles->life[i] > 0 && x >= emitter->x && y >= emitter->y
+				&& x + PARTICLE_SIZE <= emitter->x + emitter->width
+				&& y + PARTICLE_SIZE <= emitter->y + emitter->height) {
+			i++;
+			continue;
+		}
+
+		emitter->n_particles--;
+		n--;
+		particles->x[i] = particles->x[n];
+		particles->y[i] = particles->y[n];
+		particles->vx[i] = particles->vx[n];
+		particles->vy[i] = particles->vy[n];
+		particles->life[i] = particles->life[n];
+		particles->emitter[i] = particles->emitter[n];
+	}
+
+	particles->n_particles = n;
+}
+
+void particles_draw(ParticleSystem* particles) {
+
+	Surface* screen = vg_back_buffer();
+
+	/* save what's below the particles */
+	size_t e;
+	for (e = 0; e < MAX_EMITTERS; e++) {
+		Emitter* emitter = &particles->emitters[e];
+		if (emitter->n_particles == 0)
+			continue;
+
+		surface_blit(emitter->under, screen, emitter->x, emitter->y,
+				emitter->width, emitter->height, 0, 0);
+		emitter->drawn = 1;
+		emitter->dirty = 1;
+	}
+
+	/* particles never leave their emitter's area, so they aren't clipped */
+	unsigned int i;
+	for (i = 0; i < particles->n_particles; i++) {
+		const uint8_t* color = particles->emitters[particles->emitter[i]].color;
+		char* pixel = screen->pixels
+				+ (particles->y[i] >> PARTICLE_SHIFT) * screen->pitch
+				+ (particles->x[i] >> PARTICLE_SHIFT) * SURFACE_BYTES_PER_PIXEL;
+
+		int row, col;
+		for (row = 0; row < PARTICLE_SIZE; row++, pixel += screen->pitch) {
+			for (col = 0; col < PARTICLE_SIZE; col++) {
+				pixel[col * SURFACE_BYTES_PER_PIXEL] = color[0];
+				pixel[col * SURFACE_BYTES_PER_PIXEL + 1] = color[1];
+				pixel[col * SURFACE_BYTES_PER_PIXEL + 2] = color[2];
+			}
+		}
+	}
+}
+
+void particles_present(ParticleSystem* particles) {
+
+	size_t e;
+	for (e = 0; e < MAX_EMITTERS; e++) {
+		Emitter* emitter = &particles->emitters[e];
+		if (!emitter->dirty)
+			continue;
+
+		vg_copy_rect(emitter->x, emitter->y, emitter->width, emitter->height);
+		emitter->dirty = 0;
+	}
+}
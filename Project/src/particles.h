@@ -0,0 +1,137 @@
+#ifndef __PARTICLES_H
+#define __PARTICLES_H
+
+#include <stdint.h>
+#include "surface.h"
+
+/**
+ * @file particles.h
+ */
+
+/**
+ *	@defgroup Particles
+ *	@{
+ *
+ *	Particle effects. Particles live in a fixed-capacity pool stored as a
+ *	struct of arrays, so the update loop runs over plain contiguous arrays.
+ *	Each emitter owns a square area of the screen: the pixels below it are
+ *	saved before particles are drawn and restored before the next frame,
+ *	and only the areas of active emitters are presented
+ */
+
+#define MAX_PARTICLES		4096	/**< Maximum number of live particles */
+#define MAX_EMITTERS		8		/**< Maximum number of emitters at once */
+#define EMITTER_RADIUS		48		/**< Half the side of an emitter's area */
+#define PARTICLE_SIZE		2		/**< Particle's side, in pixels */
+#define PARTICLE_SHIFT		8		/**< Fractional bits of positions and speeds */
+#define PARTICLE_GRAVITY	6		/**< Downwards acceleration, per tick squared */
+
+/**
+ * @brief Particle emitter, owning an area of the screen
+*/
+typedef struct Emitter {
+	int x;						/**< Area's left-upper corner x coordinate */
+	int y;						/**< Area's left-upper corner y coordinate */
+	int width;					/**< Area's width */
+	int height;					/**< Area's height */
+	Surface* under;				/**< Pixels below the area, saved before drawing */
+	uint8_t color[3];			/**< Particles' color, in native byte order */
+	unsigned int n_particles;	/**< Number of live particles */
+	int drawn;					/**< Whether particles are on the double buffer */
+	int dirty;					/**< Whether the area must be presented */
+} Emitter;
+
+/**
+ * @brief Particle pool, as a struct of arrays
+*/
+typedef struct ParticleSystem {
+	int32_t x[MAX_PARTICLES];			/**< Particles' x coordinates, fixed point */
+	int32_t y[MAX_PARTICLES];			/**< Particles' y coordinates, fixed point */
+	int32_t vx[MAX_PARTICLES];			/**< Particles' horizontal speeds, fixed point */
+	int32_t vy[MAX_PARTICLES];			/**< Particles' vertical speeds, fixed point */
+	int32_t life[MAX_PARTICLES];		/**< Particles' remaining ticks */
+	uint8_t emitter[MAX_PARTICLES];		/**< Particles' emitters */
+	unsigned int n_particles;			/**< Number of live particles */
+	Emitter emitters[MAX_EMITTERS];		/**< Emitter slots */
+} ParticleSystem;
+
+/**
+ *  @brief Particle system creator
+ *
+ * 	Allocates the particle pool and the emitters' save-under buffers,
+ * 	so emitting particles never allocates memory.
+ *
+ *	@return Returns pointer to the particle system, NULL on failure
+ */
+ParticleSystem* initialize_particles();
+
+/**
+ *  @brief Particle system destroyer
+ *
+ *	@param particles Particle system to be destroyed
+ */
+void destroy_particles(ParticleSystem* particles);
+
+/**
+ *  @brief Drops every particle, without restoring the screen below them
+ *
+ *	@param particles Particle system to be cleared
+ */
+void particles_clear(ParticleSystem* particles);
+
+/**
+ *  @brief Emits a burst of particles
+ *
+ * 	Takes a free emitter centered at (x,y). Particles are thrown in random
+ * 	directions and die when leaving the emitter's area. Fewer particles are
+ * 	emitted when the pool is nearly full.
+ *
+ *	@param particles Particle system
+ *	@param x Burst's center x coordinate
+ *	@param y Burst's center y coordinate
+ *	@param n Number of particles to emit
+ *	@param speed Particles' maximum speed, in pixels per tick
+ *	@param life Particles' maximum life, in ticks
+ *	@param color Particles' RGB color
+ *	@return Returns the number of particles emitted
+ */
+unsigned int particles_emit(ParticleSystem* particles, int x, int y,
+		unsigned int n, int speed, int life, uint32_t color);
+
+/**
+ *  @brief Restores the double buffer below the particles drawn
+ *
+ * 	Must be called before anything else is drawn on the frame.
+ *
+ *	@param particles Particle system
+ */
+void particles_erase(ParticleSystem* particles);
+
+/**
+ *  @brief Advances every particle
+ *
+ *	@param particles Particle system
+ *	@param ticks Number of timer ticks elapsed
+ */
+void particles_update(ParticleSystem* particles, unsigned int ticks);
+
+/**
+ *  @brief Draws every particle on the double buffer
+ *
+ * 	Saves the pixels below each emitter's area first, so they are restored
+ * 	by the next particles_erase().
+ *
+ *	@param particles Particle system
+ */
+void particles_draw(ParticleSystem* particles);
+
+/**
+ *  @brief Presents the areas of the emitters drawn or erased
+ *
+ *	@param particles Particle system
+ */
+void particles_present(ParticleSystem* particles);
+
+/**@}*/
+
+#endif /* __PARTICLES_H */
@@ -0,0 +1,596 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "png.h"
+
+#define PNG_WINDOW_MASK		(PNG_WINDOW_SIZE - 1)
+#define PNG_MAX_BITS		15
+#define PNG_FAST_MASK		((1 << PNG_FAST_BITS) - 1)
+#define PNG_LOW_BITS		0x7f7f7f7fu		/**< Every byte's 7 low bits */
+#define PNG_HIGH_BITS		0x80808080u		/**< Every byte's high bit */
+#define PNG_ODD_BITS		0xfefefefeu		/**< Every byte's 7 high bits */
+
+/** Base lengths of length codes 257 to 285 */
+static const uint16_t length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15,
+		17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227,
+		258 };
+
+/** Extra bits of length codes 257 to 285 */
+static const uint8_t length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1,
+		2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+/** Base distances of distance codes 0 to 29 */
+static const uint16_t dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33,
+		49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+		6145, 8193, 12289, 16385, 24577 };
+
+/** Extra bits of distance codes 0 to 29 */
+static const uint8_t dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5,
+		5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/** Order code length code lengths are stored in */
+static const uint8_t code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10,
+		5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+static const unsigned char signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+
+/** Reads a big-endian 32 bit integer */
+static uint32_t png_u32(const unsigned char* bytes) {
+
+	return ((uint32_t) bytes[0] << 24) | ((uint32_t) bytes[1] << 16)
+			| ((uint32_t) bytes[2] << 8) | bytes[3];
+}
+
+/** Reads a whole file, returning NULL on failure */
+static unsigned char* png_read_file(const char* path, size_t* size) {
+
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+
+	long length;
+	if (fseek(file, 0, SEEK_END) != 0 || (length = ftell(file)) < 0
+			|| fseek(file, 0, SEEK_SET) != 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	unsigned char* bytes = (unsigned char *) malloc(length > 0 ? length : 1);
+	if (bytes == NULL || fread(bytes, 1, length, file) != (size_t) length) {
+		free(bytes);
+		fclose(file);
+		return NULL;
+	}
+
+	fclose(file);
+	*size = length;
+	return bytes;
+}
+
+int png_info(const char* path, int* width, int* height, size_t* size) {
+
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return 1;
+
+	/* the signature and the IHDR chunk come first */
+	unsigned char header[8 + 16];
+	long length = -1;
+	int valid = fread(header, 1, sizeof(header), file) == sizeof(header)
+			&& memcmp(header, signature, 8) == 0
+			&& memcmp(header + 12, "IHDR", 4) == 0
+			&& fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) >= 0;
+	fclose(file);
+	if (!valid)
+		return 1;
+
+	*width = png_u32(header + 16);
+	*height = png_u32(header + 20);
+	*size = length;
+	return 0;
+}
+
+PngDecoder* png_open(const char* path) {
+
+	size_t size;
+	unsigned char* file = png_read_file(path, &size);
+	if (file == NULL)
+		return NULL;
+
+	if (size < 8 + 25 || memcmp(file, signature, 8) != 0
+			|| png_u32(file + 8) != 13 || memcmp(file + 12, "IHDR", 4) != 0) {
+		free(file);
+		return NULL;
+	}
+
+	/* only 8-bit RGB or RGBA, non-interlaced */
+	const unsigned char* ihdr = file + 16;
+	uint32_t width = png_u32(ihdr), height = png_u32(ihdr + 4);
+	int channels = ihdr[9] == 2 ? 3 : ihdr[9] == 6 ? 4 : 0;
+	if (width == 0 || height == 0 || width > (1 << 14) || height > (1 << 14)
+			|| ihdr[8] != 8 || channels == 0 || ihdr[10] != 0 || ihdr[11] != 0
+			|| ihdr[12] != 0) {
+		free(file);
+		return NULL;
+	}
+
+	/* IDAT chunks are concatenated, so they're inflated as a single stream */
+	size_t idat_size = 0, pos = 8;
+	while (pos + 12 <= size) {
+		uint32_t length = png_u32(file + pos);
+		if (length > size - pos - 12)
+			break;
+		if (memcmp(file + pos + 4, "IDAT", 4) == 0) {
+			memmove(file + idat_size, file + pos + 8, length);
+			idat_size += length;
+		} else if (memcmp(file + pos + 4, "IEND", 4) == 0)
+			break;
+		pos += length + 12;
+	}
+
+	PngDecoder* decoder = (PngDecoder *) malloc(sizeof(PngDecoder));
+	if (idat_size == 0 || decoder == NULL) {
+		free(decoder);
+		free(file);
+		return NULL;
+	}
+
+	decoder->width = width;
+	decoder->height = height;
+	decoder->channels = channels;
+	decoder->stride = (size_t) width * channels;
+	decoder->data = file;
+	decoder->size = idat_size;
+	decoder->row = NULL;
+	decoder->prior = NULL;
+	decoder->fixed_built = 0;
+	return decoder;
+}
+
+void png_close(PngDecoder* decoder) {
+
+	if (decoder == NULL)
+		return;
+
+	free(decoder->data);
+	free(decoder->row);
+	free(decoder->prior);
+	free(decoder);
+}
+
+/** Fills the bit buffer, with zeros once the stream ends */
+static void png_refill(PngDecoder* d) {
+
+	while (d->n_bits <= 56) {
+		if (d->pos < d->size)
+			d->bits |= (uint64_t) d->data[d->pos++] << d->n_bits;
+		else
+			d->pad_bits += 8;
+		d->n_bits += 8;
+	}
+}
+
+/** Drops n bits, -1 if some of them were past the stream's end */
+static int png_consume(PngDecoder* d, unsigned int n) {
+
+	d->bits >>= n;
+	d->n_bits -= n;
+
+	/* padding sits on top of the buffer, reaching it means running out */
+	return d->n_bits < d->pad_bits ? -1 : 0;
+}
+
+/** Returns the next n bits, up to 16, -1 once the stream ends */
+static int png_bits(PngDecoder* d, unsigned int n) {
+
+	if (d->n_bits < n)
+		png_refill(d);
+
+	int value = d->bits & ((1u << n) - 1);
+	return png_consume(d, n) < 0 ? -1 : value;
+}
+
+/** Paeth predictor */
+static unsigned char png_paeth(int a, int b, int c) {
+
+	int p = a + b - c;
+	int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+	if (pa <= pb && pa <= pc)
+		return a;
+	return pb <= pc ? b : c;
+}
+
+/** Reads four bytes as a word */
+static uint32_t png_load4(const unsigned char* bytes) {
+
+	uint32_t word;
+	memcpy(&word, bytes, 4);
+	return word;
+}
+
+/** Writes a word as four bytes */
+static void png_store4(unsigned char* bytes, uint32_t word) {
+
+	memcpy(bytes, &word, 4);
+}
+
+/** Adds two words byte by byte, each byte wrapping around on its own */
+static uint32_t png_add4(uint32_t a, uint32_t b) {
+
+	return ((a & PNG_LOW_BITS) + (b & PNG_LOW_BITS)) ^ ((a ^ b) & PNG_HIGH_BITS);
+}
+
+/** Averages two words byte by byte, rounding down */
+static uint32_t png_avg4(uint32_t a, uint32_t b) {
+
+	return (a & b) + (((a ^ b) & PNG_ODD_BITS) >> 1);
+}
+
+/** Unfilters the scanline just inflated and converts it into the surface */
+static int png_row(PngDecoder* d) {
+
+	unsigned char* raw = d->row + 1;
+	const unsigned char* prior = d->prior + 1;
+	size_t n = d->stride, bpp = d->channels, i;
+
+	/* words hold a whole RGBA pixel, so Sub and Average go a pixel at a time */
+	switch (d->row[0]) {
+	case 0:
+		break;
+	case 1:
+		if (bpp == 4) {
+			for (i = 4; i < n; i += 4)
+				png_store4(raw + i, png_add4(png_load4(raw + i), png_load4(raw + i - 4)));
+		} else {
+			for (i = bpp; i < n; i++)
+				raw[i] += raw[i - bpp];
+		}
+		break;
+	case 2:
+		for (i = 0; i + 4 <= n; i += 4)
+			png_store4(raw + i, png_add4(png_load4(raw + i), png_load4(prior + i)));
+		for (; i < n; i++)
+			raw[i] += prior[i];
+		break;
+	case 3:
+		if (bpp == 4) {
+			png_store4(raw, png_add4(png_load4(raw), png_avg4(0, png_load4(prior))));
+			for (i = 4; i < n; i += 4)
+				png_store4(raw + i, png_add4(png_load4(raw + i),
+						png_avg4(png_load4(raw + i - 4), png_load4(prior + i))));
+		} else {
+			for (i = 0; i < bpp; i++)
+				raw[i] += prior[i] >> 1;
+			for (; i < n; i++)
+				raw[i] += (raw[i - bpp] + prior[i]) >> 1;
+		}
+		break;
+	case 4:
+		for (i = 0; i < bpp; i++)
+			raw[i] += prior[i];
+		for (; i < n; i++)
+			raw[i] += png_paeth(raw[i - bpp], prior[i], prior[i - bpp]);
+		break;
+	default:
+		return 1;
+	}
+
+	/* RGB(A) to the native BGR, alpha is dropped */
+	char* pixel = d->dst->pixels + d->y * d->dst->pitch;
+	for (i = 0; i < n; i += bpp, pixel += SURFACE_BYTES_PER_PIXEL) {
+		pixel[0] = raw[i + 2];
+		pixel[1] = raw[i + 1];
+		pixel[2] = raw[i];
+	}
+
+	/* the scanline just unfiltered is the next one's prior */
+	unsigned char* swap = d->prior;
+	d->prior = d->row;
+	d->row = swap;
+	d->row_pos = 0;
+	d->y++;
+	return 0;
+}
+
+/** Appends an inflated byte */
+static int png_put(PngDecoder* d, unsigned char byte) {
+
+	d->window[d->n_out++ & PNG_WINDOW_MASK] = byte;
+
+	/* trailing bytes after the last scanline are ignored */
+	if (d->y == d->height)
+		return 0;
+
+	d->row[d->row_pos++] = byte;
+	return d->row_pos == d->stride + 1 ? png_row(d) : 0;
+}
+
+/** Builds a canonical Huffman code from its code lengths */
+static int png_build(PngHuffman* h, const uint8_t* lengths, unsigned int n) {
+
+	uint16_t offsets[PNG_MAX_BITS + 1], codes[PNG_MAX_BITS + 1];
+	unsigned int i, j;
+
+	memset(h->count, 0, sizeof(h->count));
+	for (i = 0; i < n; i++)
+		h->count[lengths[i]]++;
+	h->count[0] = 0;
+
+	/* over-subscribed codes are rejected */
+	int left = 1;
+	for (i = 1; i <= PNG_MAX_BITS; i++) {
+		left = (left << 1) - h->count[i];
+		if (left < 0)
+			return 1;
+	}
+
+	offsets[1] = 0;
+	for (i = 1; i < PNG_MAX_BITS; i++)
+		offsets[i + 1] = offsets[i] + h->count[i];
+
+	for (i = 0; i < n; i++)
+		if (lengths[i] != 0)
+			h->symbol[offsets[lengths[i]]++] = i;
+
+	/* short codes fill every table entry their bits start, reversed since
+	 * deflate stores codes first bit first */
+	memset(h->fast, 0, sizeof(h->fast));
+	codes[1] = 0;
+	for (i = 1; i < PNG_MAX_BITS; i++)
+		codes[i + 1] = (codes[i] + h->count[i]) << 1;
+
+	for (i = 0; i < n; i++) {
+		unsigned int length = lengths[i];
+		if (length == 0 || length > PNG_FAST_BITS)
+			continue;
+
+		unsigned int code = codes[length]++, reversed = 0;
+		for (j = 0; j < length; j++)
+			reversed |= ((code >> j) & 1) << (length - 1 - j);
+		for (j = reversed; j < (1 << PNG_FAST_BITS); j += 1 << length)
+			h->fast[j] = (i << 4) | length;
+	}
+
+	return 0;
+}
+
+/** Decodes a symbol, -1 on failure */
+static int png_decode_symbol(PngDecoder* d, const PngHuffman* h) {
+
+	if (d->n_bits < PNG_MAX_BITS)
+		png_refill(d);
+
+	unsigned int entry = h->fast[d->bits & PNG_FAST_MASK];
+	if (entry != 0)
+		return png_consume(d, entry & 0xf) < 0 ? -1 : (int) (entry >> 4);
+
+	/* longer codes are walked bit by bit */
+	uint64_t bits = d->bits;
+	int code = 0, first = 0, index = 0;
+	unsigned int len;
+
+	for (len = 1; len <= PNG_MAX_BITS; len++, bits >>= 1) {
+		code |= bits & 1;
+		int count = h->count[len];
+		if (code - count < first)
+			return png_consume(d, len) < 0 ? -1 : h->symbol[index + (code - first)];
+
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+
+	return -1;
+}
+
+/** Inflates a stored block */
+static int png_stored(PngDecoder* d) {
+
+	/* stored blocks start at a byte boundary */
+	d->bits >>= d->n_bits & 7;
+	d->n_bits -= d->n_bits & 7;
+
+	int len = png_bits(d, 16), nlen = png_bits(d, 16);
+	if (len < 0 || nlen < 0 || len != (~nlen & 0xffff))
+		return 1;
+
+	while (len-- > 0) {
+		int byte = png_bits(d, 8);
+		if (byte < 0 || png_put(d, byte) != 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+/** Inflates a block of Huffman coded literals and matches */
+static int png_codes(PngDecoder* d, const PngHuffman* lit, const PngHuffman* dist) {
+
+	for (;;) {
+		int symbol = png_decode_symbol(d, lit);
+		if (symbol < 0)
+			return 1;
+
+		if (symbol < 256) {
+			if (png_put(d, symbol) != 0)
+				return 1;
+			continue;
+		}
+
+		if (symbol == 256)
+			return 0;
+
+		symbol -= 257;
+		if (symbol >= 29)
+			return 1;
+		int extra = png_bits(d, length_extra[symbol]);
+		if (extra < 0)
+			return 1;
+		int length = length_base[symbol] + extra;
+
+		symbol = png_decode_symbol(d, dist);
+		if (symbol < 0 || symbol >= 30)
+			return 1;
+		extra = png_bits(d, dist_extra[symbol]);
+		if (extra < 0)
+			return 1;
+		size_t distance = dist_base[symbol] + extra;
+		if (distance > d->n_out)
+			return 1;
+
+		while (length-- > 0)
+			if (png_put(d, d->window[(d->n_out - distance) & PNG_WINDOW_MASK]) != 0)
+				return 1;
+	}
+}
+
+/** Inflates a block with the fixed Huffman codes */
+static int png_fixed(PngDecoder* d) {
+
+	/* built per decoder, so images may be decoded concurrently */
+	if (!d->fixed_built) {
+		uint8_t lengths[288];
+		unsigned int i;
+		for (i = 0; i < 144; i++)
+			lengths[i] = 8;
+		for (; i < 256; i++)
+			lengths[i] = 9;
+		for (; i < 280; i++)
+			lengths[i] = 7;
+		for (; i < 288; i++)
+			lengths[i] = 8;
+		png_build(&d->fixed_lit, lengths, 288);
+
+		for (i = 0; i < 30; i++)
+			lengths[i] = 5;
+		png_build(&d->fixed_dist, lengths, 30);
+		d->fixed_built = 1;
+	}
+
+	return png_codes(d, &d->fixed_lit, &d->fixed_dist);
+}
+
+/** Inflates a block with dynamic Huffman codes */
+static int png_dynamic(PngDecoder* d) {
+
+	PngHuffman lit, dist;
+	uint8_t lengths[288 + 32];
+
+	int n_lit = png_bits(d, 5), n_dist = png_bits(d, 5), n_len = png_bits(d, 4);
+	if (n_lit < 0 || n_dist < 0 || n_len < 0)
+		return 1;
+	n_lit += 257;
+	n_dist += 1;
+	n_len += 4;
+	if (n_lit > 286 || n_dist > 30)
+		return 1;
+
+	/* code lengths' own code */
+	int i;
+	memset(lengths, 0, 19);
+	for (i = 0; i < n_len; i++) {
+		int length = png_bits(d, 3);
+		if (length < 0)
+			return 1;
+		lengths[code_length_order[i]] = length;
+	}
+	if (png_build(&lit, lengths, 19) != 0)
+		return 1;
+
+	/* literal/length and distance code lengths, run-length encoded */
+	i = 0;
+	while (i < n_lit + n_dist) {
+		int symbol = png_decode_symbol(d, &lit);
+		if (symbol < 0)
+			return 1;
+
+		if (symbol < 16) {
+			lengths[i++] = symbol;
+			continue;
+		}
+
+		int length = 0, repeat;
+		if (symbol == 16) {
+			if (i == 0)
+				return 1;
+			length = lengths[i - 1];
+			repeat = png_bits(d, 2);
+			repeat = repeat < 0 ? -1 : 3 + repeat;
+		} else if (symbol == 17) {
+			repeat = png_bits(d, 3);
+			repeat = repeat < 0 ? -1 : 3 + repeat;
+		} else {
+			repeat = png_bits(d, 7);
+			repeat = repeat < 0 ? -1 : 11 + repeat;
+		}
+
+		if (repeat < 0 || i + repeat > n_lit + n_dist)
+			return 1;
+		while (repeat-- > 0)
+			lengths[i++] = length;
+	}
+
+	if (lengths[256] == 0 || png_build(&lit, lengths, n_lit) != 0
+			|| png_build(&dist, lengths + n_lit, n_dist) != 0)
+		return 1;
+
+	return png_codes(d, &lit, &dist);
+}
+
+int png_decode(PngDecoder* d, Surface* dst) {
+
+	if (dst->width != d->width || dst->height != d->height)
+		return 1;
+
+	/* only two scanlines are ever held, the current one and its prior */
+	d->row = (unsigned char *) malloc(d->stride + 1);
+	d->prior = (unsigned char *) calloc(d->stride + 1, 1);
+	if (d->row == NULL || d->prior == NULL)
+		return 1;
+
+	d->dst = dst;
+	d->pos = 0;
+	d->bits = 0;
+	d->n_bits = 0;
+	d->pad_bits = 0;
+	d->n_out = 0;
+	d->row_pos = 0;
+	d->y = 0;
+
+	/* zlib header: deflate, no preset dictionary */
+	int cmf = png_bits(d, 8), flg = png_bits(d, 8);
+	if (cmf < 0 || flg < 0 || (cmf & 0x0f) != 8 || (flg & 0x20) != 0
+			|| ((cmf << 8) | flg) % 31 != 0)
+		return 1;
+
+	int last;
+	do {
+		last = png_bits(d, 1);
+		int type = png_bits(d, 2), error;
+
+		if (last < 0 || type < 0)
+			return 1;
+
+		switch (type) {
+		case 0:
+			error = png_stored(d);
+			break;
+		case 1:
+			error = png_fixed(d);
+			break;
+		case 2:
+			error = png_dynamic(d);
+			break;
+		default:
+			error = 1;
+			break;
+		}
+
+		if (error)
+			return 1;
+	} while (!last);
+
+	return d->y != d->height;
+}
@@ -0,0 +1,102 @@
+#ifndef __PNG_H
+#define __PNG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "surface.h"
+
+/**
+ * @file png.h
+ */
+
+/**
+ *	@defgroup PNG
+ *	@{
+ *
+ *	Streaming PNG decoder for the game's own images: 8-bit RGB or RGBA,
+ *	non-interlaced. Inflated bytes are unfiltered one scanline at a time and
+ *	written, already in native format, straight into the destination surface,
+ *	so the whole image never exists in any other format. Huffman codes are
+ *	looked up in tables, bits are read from a 64-bit buffer, and scanlines
+ *	are unfiltered four bytes at a time where the filter allows it. Other
+ *	PNGs are left for stb_image
+ */
+
+#define PNG_WINDOW_SIZE		32768	/**< Inflate's sliding window size */
+#define PNG_FAST_BITS		9		/**< Longest code looked up in a single step */
+
+/**
+ * @brief Canonical Huffman code
+*/
+typedef struct PngHuffman {
+	uint16_t count[16];		/**< Number of codes of each length */
+	uint16_t symbol[288];	/**< Symbols ordered by code */
+	uint16_t fast[1 << PNG_FAST_BITS];	/**< Symbol and length of short codes by their next bits, 0 if longer */
+} PngHuffman;
+
+/**
+ * @brief Streaming PNG decoder
+*/
+typedef struct PngDecoder {
+	int width;							/**< Image's width */
+	int height;							/**< Image's height */
+	int channels;						/**< Bytes per pixel, 3 or 4 */
+	size_t stride;						/**< Scanline's size, without its filter byte */
+	unsigned char* data;				/**< Concatenated IDAT chunks */
+	size_t size;						/**< Size of the IDAT data */
+	size_t pos;							/**< Next IDAT byte to be read */
+	uint64_t bits;						/**< Bits read but not consumed */
+	unsigned int n_bits;				/**< Number of bits read but not consumed */
+	unsigned int pad_bits;				/**< Zero bits buffered past the IDAT data's end */
+	unsigned char window[PNG_WINDOW_SIZE];	/**< Last inflated bytes */
+	size_t n_out;						/**< Number of inflated bytes */
+	unsigned char* row;					/**< Scanline being inflated, filter byte first */
+	unsigned char* prior;				/**< Previous scanline, unfiltered */
+	size_t row_pos;						/**< Bytes inflated into the scanline */
+	int y;								/**< Scanline being inflated */
+	Surface* dst;						/**< Surface being decoded into */
+	PngHuffman fixed_lit;				/**< Fixed literal/length code */
+	PngHuffman fixed_dist;				/**< Fixed distance code */
+	int fixed_built;					/**< Whether the fixed codes were built */
+} PngDecoder;
+
+/**
+ *  @brief Reads a PNG image's size from its header, without decoding it
+ *
+ *	@param path PNG image's path
+ *	@param width Returns the image's width
+ *	@param height Returns the image's height
+ *	@param size Returns the file's size in bytes
+ *	@return Returns 0 upon success and non-zero if it isn't a readable PNG
+ */
+int png_info(const char* path, int* width, int* height, size_t* size);
+
+/**
+ *  @brief Opens a PNG image
+ *
+ * 	Reads its chunks and checks it's supported by the streaming decoder.
+ *
+ *	@param path PNG image's path
+ *	@return Returns pointer to the decoder, NULL if unsupported or unreadable
+ */
+PngDecoder* png_open(const char* path);
+
+/**
+ *  @brief Decodes an opened PNG image into a surface
+ *
+ *	@param decoder PNG decoder
+ *	@param dst Surface with the image's dimensions
+ *	@return Returns 0 upon success and non-zero if the image is corrupt
+ */
+int png_decode(PngDecoder* decoder, Surface* dst);
+
+/**
+ *  @brief Closes a PNG image, freeing its decoder
+ *
+ *	@param decoder PNG decoder
+ */
+void png_close(PngDecoder* decoder);
+
+/**@}*/
+
+#endif /* __PNG_H */
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "profile.h"
+#include "cycles.h"
+
+static ProfilePhase phases[PROFILE_MAX_PHASES];	/**< Phases recorded */
+static unsigned int n_phases = 0;				/**< Number of phases recorded */
+static unsigned int depth = 0;					/**< Number of phases running */
+
+static unsigned int n_ticks = 0;				/**< Timer ticks seen while calibrating */
+static uint64_t first_tick = 0;					/**< Time stamp of the first tick seen */
+static unsigned long cycles_per_ms = 0;			/**< Counter's frequency, 0 if unknown */
+
+int profile_begin(const char* name) {
+
+	if (n_phases == PROFILE_MAX_PHASES)
+		return -1;
+
+	ProfilePhase* phase = &phases[n_phases];
+	snprintf(phase->name, PROFILE_NAME_MAX, "%s", name);
+	phase->depth = depth++;
+	phase->cycles = 0;
+	phase->count = 0;
+	phase->start = cycles_read();
+
+	return n_phases++;
+}
+
+void profile_end(int phase) {
+
+	if (phase < 0)
+		return;
+
+	phases[phase].cycles = cycles_read() - phases[phase].start;
+	depth--;
+}
+
+void profile_count(int phase, unsigned long count) {
+
+	if (phase >= 0)
+		phases[phase].count = count;
+}
+
+void profile_tick(unsigned int frequency) {
+
+	if (cycles_per_ms != 0)
+		return;
+
+	/* the first tick may come at any time, so timing starts on it */
+	if (n_ticks++ == 0) {
+		first_tick = cycles_read();
+		return;
+	}
+
+	if (n_ticks > PROFILE_CALIBRATION)
+		cycles_per_ms = (cycles_read() - first_tick) * frequency
+				/ (1000 * (n_ticks - 1));
+}
+
+/** Prints every phase recorded to a stream */
+static void profile_print(FILE* stream) {
+
+	fprintf(stream, "%-*s %10s %12s %8s\n", PROFILE_NAME_MAX + 4, "Startup phase",
+			"time (us)", "kcycles", "retries");
+
+	unsigned int i;
+	for (i = 0; i < n_phases; i++) {
+		ProfilePhase* phase = &phases[i];
+
+		fprintf(stream, "%*s%-*s ", 2 * phase->depth, "",
+				PROFILE_NAME_MAX + 4 - 2 * phase->depth, phase->name);
+		if (cycles_per_ms != 0)
+			fprintf(stream, "%10lu ", (unsigned long) (phase->cycles * 1000 / cycles_per_ms));
+		else
+			fprintf(stream, "%10s ", "?");
+		fprintf(stream, "%12lu %8lu\n", (unsigned long) (phase->cycles / 1000),
+				phase->count);
+	}
+}
+
+unsigned long profile_cycles_per_ms() {
+
+	return cycles_per_ms;
+}
+
+void profile_report() {
+
+	profile_print(stdout);
+}
+
+int profile_log(const char* path) {
+
+	FILE* log = fopen(path, "a");
+	if (log == NULL) {
+		printf("Couldn't open the startup log \"%s\"!\n", path);
+		return 1;
+	}
+
+	time_t now = time(NULL);
+	fprintf(log, "\n%s", ctime(&now));
+	profile_print(log);
+
+	return fclose(log) != 0;
+}
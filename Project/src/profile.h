@@ -0,0 +1,90 @@
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * @file profile.h
+ */
+
+/**
+ *	@defgroup Profile
+ *	@{
+ *
+ *	Startup profiler, timing each initialization phase with the processor's
+ *	time stamp counter. Cycles are converted to time once the counter was
+ *	calibrated against the timer's interrupts
+ */
+
+#define PROFILE_MAX_PHASES		32	/**< Maximum number of phases recorded */
+#define PROFILE_NAME_MAX		40	/**< Maximum length of a phase's name */
+#define PROFILE_CALIBRATION		30	/**< Timer ticks used to calibrate the counter */
+
+/**
+ * @brief Profiled phase
+*/
+typedef struct ProfilePhase {
+	char name[PROFILE_NAME_MAX];	/**< Phase's name */
+	unsigned int depth;				/**< Number of phases it's nested in */
+	uint64_t start;					/**< Time stamp of the phase's start */
+	uint64_t cycles;				/**< Cycles the phase took */
+	unsigned long count;			/**< Events counted during the phase, such as retries */
+} ProfilePhase;
+
+/**
+ *  @brief Starts timing a phase
+ *
+ * 	Phases started before the previous one ended are nested in it.
+ *
+ *	@param name Phase's name
+ *	@return Returns the phase's id, -1 if no more phases can be recorded
+ */
+int profile_begin(const char* name);
+
+/**
+ *  @brief Stops timing a phase
+ *
+ *	@param phase Phase's id, returned by profile_begin()
+ */
+void profile_end(int phase);
+
+/**
+ *  @brief Records the number of events that happened during a phase
+ *
+ *	@param phase Phase's id, returned by profile_begin()
+ *	@param count Number of events
+ */
+void profile_count(int phase, unsigned long count);
+
+/**
+ *  @brief Calibrates the time stamp counter
+ *
+ * 	Must be called on every timer interrupt, until calibrated.
+ *
+ *	@param frequency Timer interrupts' frequency
+ */
+void profile_tick(unsigned int frequency);
+
+/**
+ *  @brief Returns the time stamp counter's rate
+ *
+ *	@return Returns the counter's cycles per millisecond, 0 until calibrated
+ */
+unsigned long profile_cycles_per_ms();
+
+/**
+ *  @brief Prints every phase recorded
+ */
+void profile_report();
+
+/**
+ *  @brief Appends every phase recorded to a log file
+ *
+ *	@param path Log file's path
+ *	@return Returns 0 upon success and non-zero otherwise
+ */
+int profile_log(const char* path);
+
+/**@}*/
+
+#endif /* __PROFILE_H */
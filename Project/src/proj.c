@@ -6,8 +6,10 @@
 #include <errno.h>
 #include <time.h>
 #include "game.h"
+#include "video_gr.h"
 
-int main() {
+/* started with the "8bpp" argument, the game runs in an 8-bit indexed mode */
+int main(int argc, char** argv) {
 
 	sef_startup();
 	sys_enable_iop(SELF);
@@ -20,6 +22,8 @@ int main() {
 		return 1;
 	}
 
+	game->video_mode = argc > 1 && strcmp(argv[1], "8bpp") == 0 ? VG_MODE_8BPP
+			: VG_MODE_24BPP;
 	game->current_state = INIT;
 	handle_event(game, NO_EVENT);
 	return 0;
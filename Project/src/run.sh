@@ -1,2 +1,2 @@
 cd ..
-service run `pwd`/proj
\ No newline at end of file
+service run `pwd`/proj -args "$1"
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "sprite.h"
+#include "video_gr.h"
+
+SpriteSheet* create_sprite_sheet(int frame_width, int frame_height,
+		unsigned int n_frames, unsigned int columns) {
+
+	SpriteSheet* sheet = (SpriteSheet *) malloc(sizeof(SpriteSheet));
+	if (sheet == NULL)
+		return NULL;
+
+	unsigned int rows = (n_frames + columns - 1) / columns;
+	sheet->surface = surface_create(frame_width * columns, frame_height * rows);
+	if (sheet->surface == NULL) {
+		free(sheet);
+		return NULL;
+	}
+
+	sheet->frame_width = frame_width;
+	sheet->frame_height = frame_height;
+	sheet->n_frames = n_frames;
+	sheet->columns = columns;
+	return sheet;
+}
+
+void destroy_sprite_sheet(SpriteSheet* sheet) {
+
+	if (sheet == NULL)
+		return;
+
+	surface_destroy(sheet->surface);
+	free(sheet);
+}
+
+void sprite_frame_coords(const SpriteSheet* sheet, unsigned int frame, int* x, int* y) {
+
+	*x = (frame % sheet->columns) * sheet->frame_width;
+	*y = (frame / sheet->columns) * sheet->frame_height;
+}
+
+void animator_init(Animator* animator) {
+
+	size_t i;
+	for (i = 0; i < MAX_ANIMATIONS; i++) {
+		animator->animations[i].active = 0;
+		animator->animations[i].damaged = 0;
+	}
+
+	animator->n_active = 0;
+	animator->tick = 0;
+}
+
+Animation* animation_play(Animator* animator, const SpriteSheet* sheet,
+		unsigned int first_frame, unsigned int n_frames,
+		unsigned int ticks_per_frame, anim_mode_t mode, int x, int y) {
+
+	size_t i;
+	for (i = 0; i < MAX_ANIMATIONS; i++) {
+		Animation* animation = &animator->animations[i];
+		if (animation->active)
+			continue;
+
+		animation->sheet = sheet;
+		animation->first_frame = first_frame;
+		animation->n_frames = n_frames;
+		animation->ticks_per_frame = ticks_per_frame;
+		animation->mode = mode;
+		animation->start_tick = animator->tick;
+		animation->x = x;
+		animation->y = y;
+		animation->frame = -1;
+		animation->dirty = 1;
+		animation->damaged = 0;
+		animation->active = 1;
+		animator->n_active++;
+		return animation;
+	}
+
+	return NULL;
+}
+
+void animation_stop(Animator* animator, Animation* animation) {
+
+	if (animation == NULL || !animation->active)
+		return;
+
+	animation->active = 0;
+	animator->n_active--;
+}
+
+void animation_move(Animation* animation, int x, int y) {
+
+	if (animation->x != x || animation->y != y) {
+		animation->x = x;
+		animation->y = y;
+		animation->dirty = 1;
+	}
+}
+
+void animation_set_frames(Animation* animation, unsigned int first_frame) {
+
+	if (animation->first_frame != first_frame) {
+		animation->first_frame = first_frame;
+		animation->dirty = 1;
+	}
+}
+
+/** Computes the frame an animation shows at a given tick */
+static int animation_frame(Animation* animation, unsigned long tick) {
+
+	unsigned long elapsed = (tick - animation->start_tick)
+			/ animation->ticks_per_frame;
+	unsigned int n = animation->n_frames;
+
+	switch (animation->mode) {
+	case ANIM_ONCE:
+		return elapsed < n ? elapsed : n - 1;
+	case ANIM_LOOP:
+		return elapsed % n;
+	case ANIM_PINGPONG:
+		if (n < 2)
+			return 0;
+		elapsed %= 2 * n - 2;
+		return elapsed < n ? elapsed : 2 * n - 2 - elapsed;
+	default:
+		return 0;
+	}
+}
+
+void animation_draw(Animation* animation) {
+
+	const SpriteSheet* sheet = animation->sheet;
+	int x, y;
+
+	if (animation->frame < 0)
+		animation->frame = 0;
+
+	sprite_frame_coords(sheet, animation->first_frame + animation->frame, &x, &y);
+	surface_blit(vg_back_buffer(), sheet->surface, x, y, sheet->frame_width,
+			sheet->frame_height, animation->x, animation->y);
+	animation->dirty = 0;
+}
+
+int animator_update(Animator* animator) {
+
+	unsigned long tick = ++animator->tick;
+
+	/* nothing animating costs nothing */
+	if (animator->n_active == 0)
+		return 0;
+
+	int n_drawn = 0;
+	size_t i;
+	for (i = 0; i < MAX_ANIMATIONS; i++) {
+		Animation* animation = &animator->animations[i];
+		if (!animation->active)
+			continue;
+
+		int frame = animation_frame(animation, tick);
+		if (frame != animation->frame || animation->dirty) {
+			animation->frame = frame;
+			animation_draw(animation);
+			animation->damaged = 1;
+			n_drawn++;
+		}
+
+		/* single shot animations end on their last frame */
+		if (animation->mode == ANIM_ONCE && frame == animation->n_frames - 1)
+			animation_stop(animator, animation);
+	}
+
+	return n_drawn;
+}
+
+void animator_redraw(Animator* animator) {
+
+	if (animator->n_active == 0)
+		return;
+
+	size_t i;
+	for (i = 0; i < MAX_ANIMATIONS; i++)
+		if (animator->animations[i].active)
+			animation_draw(&animator->animations[i]);
+}
+
+int animator_damaged(Animator* animator, int x, int y, int width, int height) {
+
+	size_t i;
+	for (i = 0; i < MAX_ANIMATIONS; i++) {
+		Animation* animation = &animator->animations[i];
+		if (!animation->damaged)
+			continue;
+
+		if (x < animation->x + animation->sheet->frame_width
+				&& animation->x < x + width
+				&& y < animation->y + animation->sheet->frame_height
+				&& animation->y < y + height)
+			return 1;
+	}
+
+	return 0;
+}
+
+void animator_present(Animator* animator) {
+
+	size_t i;
+	for (i = 0; i < MAX_ANIMATIONS; i++) {
+		Animation* animation = &animator->animations[i];
+		if (!animation->damaged)
+			continue;
+
+		vg_copy_rect(animation->x, animation->y, animation->sheet->frame_width,
+				animation->sheet->frame_height);
+		animation->damaged = 0;
+	}
+}
@@ -0,0 +1,203 @@
+#ifndef __SPRITE_H
+#define __SPRITE_H
+
+#include "surface.h"
+
+/**
+ * @file sprite.h
+ */
+
+/**
+ *	@defgroup Sprite
+ *	@{
+ *
+ *	Sprite sheets and their time-based animation. Only the area covered by
+ *	an animation is redrawn, and only when its frame or position changes
+ */
+
+#define MAX_ANIMATIONS	8	/**< Maximum number of animations playing at once */
+
+/**
+ * @brief Animation playback modes
+*/
+typedef enum { ANIM_ONCE, ANIM_LOOP, ANIM_PINGPONG } anim_mode_t;
+
+/**
+ * @brief Sprite sheet, storing equally sized frames in a grid
+*/
+typedef struct SpriteSheet {
+	Surface* surface;			/**< Sheet's frames, in native format */
+	int frame_width;			/**< Frame's width */
+	int frame_height;			/**< Frame's height */
+	unsigned int n_frames;		/**< Sheet's number of frames */
+	unsigned int columns;		/**< Number of frames per row of the sheet */
+} SpriteSheet;
+
+/**
+ * @brief Animation playing frames from a sprite sheet
+*/
+typedef struct Animation {
+	const SpriteSheet* sheet;		/**< Animation's sprite sheet */
+	unsigned int first_frame;		/**< Animation's first frame in the sheet */
+	unsigned int n_frames;			/**< Animation's number of frames */
+	unsigned int ticks_per_frame;	/**< Timer ticks each frame is shown */
+	anim_mode_t mode;				/**< Animation's playback mode */
+	unsigned long start_tick;		/**< Timer tick when the animation started */
+	int x;							/**< Animation's x coordinate on the screen */
+	int y;							/**< Animation's y coordinate on the screen */
+	int frame;						/**< Frame currently on the screen, -1 if none */
+	int dirty;						/**< Whether it must be redrawn on the next update */
+	int damaged;					/**< Whether it was drawn on the last update */
+	int active;						/**< Whether the animation is playing */
+} Animation;
+
+/**
+ * @brief Set of animations playing on the screen
+*/
+typedef struct Animator {
+	Animation animations[MAX_ANIMATIONS];	/**< Animation slots */
+	unsigned int n_active;					/**< Number of animations playing */
+	unsigned long tick;						/**< Timer ticks counted by the animator */
+} Animator;
+
+/**
+ *  @brief Sprite sheet creator
+ *
+ * 	Allocates a sprite sheet for "n_frames" frames, laid out in rows of
+ * 	"columns" frames. The frames are left for the caller to draw.
+ *
+ *	@param frame_width Frame's width
+ *	@param frame_height Frame's height
+ *	@param n_frames Sheet's number of frames
+ *	@param columns Number of frames per row of the sheet
+ *	@return Returns pointer to the sprite sheet, NULL on failure
+ */
+SpriteSheet* create_sprite_sheet(int frame_width, int frame_height,
+		unsigned int n_frames, unsigned int columns);
+
+/**
+ *  @brief Sprite sheet destroyer
+ *
+ *	@param sheet Sprite sheet to be destroyed
+ */
+void destroy_sprite_sheet(SpriteSheet* sheet);
+
+/**
+ *  @brief Computes a frame's position in its sprite sheet
+ *
+ *	@param sheet Sprite sheet
+ *	@param frame Frame's index
+ *	@param x Frame's left-upper corner x coordinate in the sheet
+ *	@param y Frame's left-upper corner y coordinate in the sheet
+ */
+void sprite_frame_coords(const SpriteSheet* sheet, unsigned int frame, int* x, int* y);
+
+/**
+ *  @brief Animator initializer
+ *
+ * 	Stops every animation.
+ *
+ *	@param animator Animator to be initialized
+ */
+void animator_init(Animator* animator);
+
+/**
+ *  @brief Starts an animation
+ *
+ *	@param animator Animator to play the animation in
+ *	@param sheet Animation's sprite sheet
+ *	@param first_frame Animation's first frame in the sheet
+ *	@param n_frames Animation's number of frames
+ *	@param ticks_per_frame Timer ticks each frame is shown
+ *	@param mode Animation's playback mode
+ *	@param x Animation's x coordinate on the screen
+ *	@param y Animation's y coordinate on the screen
+ *	@return Returns pointer to the animation, NULL if all slots are taken
+ */
+Animation* animation_play(Animator* animator, const SpriteSheet* sheet,
+		unsigned int first_frame, unsigned int n_frames,
+		unsigned int ticks_per_frame, anim_mode_t mode, int x, int y);
+
+/**
+ *  @brief Stops an animation
+ *
+ * 	The animation's last frame is left on the screen.
+ *
+ *	@param animator Animator playing the animation
+ *	@param animation Animation to be stopped
+ */
+void animation_stop(Animator* animator, Animation* animation);
+
+/**
+ *  @brief Moves an animation on the screen
+ *
+ *	@param animation Animation to be moved
+ *	@param x Animation's new x coordinate
+ *	@param y Animation's new y coordinate
+ */
+void animation_move(Animation* animation, int x, int y);
+
+/**
+ *  @brief Changes the frames an animation plays
+ *
+ * 	The animation keeps its timing, only the sheet's frames change.
+ *
+ *	@param animation Animation to be changed
+ *	@param first_frame Animation's new first frame in the sheet
+ */
+void animation_set_frames(Animation* animation, unsigned int first_frame);
+
+/**
+ *  @brief Draws an animation's current frame on the double buffer
+ *
+ *	@param animation Animation to be drawn
+ */
+void animation_draw(Animation* animation);
+
+/**
+ *  @brief Updates every animation
+ *
+ * 	Must be called once per timer tick. Draws on the double buffer the
+ * 	animations whose frame or position changed since the last update,
+ * 	without presenting them. Returns immediately when nothing is animating.
+ *
+ *	@param animator Animator to be updated
+ *	@return Returns the number of animations drawn
+ */
+int animator_update(Animator* animator);
+
+/**
+ *  @brief Redraws every animation
+ *
+ * 	Draws every animation's current frame on the double buffer, without
+ * 	presenting them. Meant to be called after the area below them was
+ * 	redrawn.
+ *
+ *	@param animator Animator to be redrawn
+ */
+void animator_redraw(Animator* animator);
+
+/**
+ *  @brief Tests whether the last update drew over a rectangle
+ *
+ *	@param animator Animator to be tested
+ *	@param x Rectangle's left-upper corner x coordinate
+ *	@param y Rectangle's left-upper corner y coordinate
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ *	@return Returns 1 if any animation drawn intersects the rectangle and 0 otherwise
+ */
+int animator_damaged(Animator* animator, int x, int y, int width, int height);
+
+/**
+ *  @brief Presents the animations drawn on the last update
+ *
+ * 	Copies to the screen only the rectangles of the animations drawn.
+ *
+ *	@param animator Animator to be presented
+ */
+void animator_present(Animator* animator);
+
+/**@}*/
+
+#endif /* __SPRITE_H */
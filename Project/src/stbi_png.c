@@ -1,14 +1,58 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include "stbi_png.h"
+#include "arena.h"
+#include "png.h"
+
+/* on host builds each thread decodes with its own scratch arena */
+#ifdef __minix
+#define SCRATCH_LOCAL
+#else
+#define SCRATCH_LOCAL	__thread
+#endif
+
+static SCRATCH_LOCAL Arena scratch;	/**< Decoding temporaries and the decoded image */
+
+static void* stbi_arena_malloc(size_t size);
+static void* stbi_arena_realloc(void* ptr, size_t old_size, size_t new_size);
+static void stbi_arena_free(void* ptr);
+
+/* stb_image allocates from the scratch arena */
+#define STBI_MALLOC(size)							stbi_arena_malloc(size)
+#define STBI_REALLOC_SIZED(ptr, old_size, new_size)	stbi_arena_realloc(ptr, old_size, new_size)
+#define STBI_FREE(ptr)								stbi_arena_free(ptr)
 
 #define STBI_ONLY_PNG
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+/** Bounds the memory decoding a PNG takes: its compressed data, read into a
+ * buffer that doubles, the inflated scanlines, the image as stored and the
+ * image converted to 3 channels. Interlaced images' passes are inflated
+ * into the scanlines' room */
+static size_t stbi_scratch_size(const char* image_path) {
+
+	int width, height;
+	size_t size;
+	if (png_info(image_path, &width, &height, &size) != 0)
+		return 0;
+
+	size_t n_pixels = (size_t) width * height;
+	return 2 * size + (4 * (size_t) width + 1) * height + 4 * n_pixels + 3 * n_pixels
+			+ STBI_SCRATCH_SLACK;
+}
+
 unsigned char* stbi_png_load(int* width, int* height, const char* image_path) {
 
+	/* the scratch arena grows to the largest image decoded so far */
+	size_t size = stbi_scratch_size(image_path);
+	if (size > scratch.size) {
+		arena_destroy(&scratch);
+		arena_init(&scratch, size);
+	}
+
 	int n;
 	unsigned char* image = stbi_load(image_path, width, height, &n, 3);
 	if(image == NULL) {
@@ -21,5 +65,51 @@ unsigned char* stbi_png_load(int* width, int* height, const char* image_path) {
 
 void stbi_free(unsigned char* image) {
 
-	stbi_image_free(image);
+	/* the image outlives every temporary of its decoding, wherever it is */
+	if (!arena_contains(&scratch, image))
+		stbi_image_free(image);
+	arena_reset(&scratch);
+}
+
+void stbi_png_cleanup() {
+
+	if (scratch.base == NULL)
+		return;
+
+	arena_report(&scratch, "PNG decoding");
+	arena_destroy(&scratch);
+}
+
+/** Allocates from the scratch arena, or from the heap once it's full */
+static void* stbi_arena_malloc(size_t size) {
+
+	if (scratch.base == NULL)
+		return malloc(size);
+
+	void* ptr = arena_alloc(&scratch, size);
+	return ptr != NULL ? ptr : malloc(size);
+}
+
+static void* stbi_arena_realloc(void* ptr, size_t old_size, size_t new_size) {
+
+	if (ptr == NULL)
+		return stbi_arena_malloc(new_size);
+	if (!arena_contains(&scratch, ptr))
+		return realloc(ptr, new_size);
+
+	void* resized = arena_realloc(&scratch, ptr, old_size, new_size);
+	if (resized == NULL) {
+		resized = malloc(new_size);
+		if (resized != NULL)
+			memcpy(resized, ptr, old_size < new_size ? old_size : new_size);
+	}
+
+	return resized;
+}
+
+/** Memory from the scratch arena is only reclaimed when it's reset */
+static void stbi_arena_free(void* ptr) {
+
+	if (!arena_contains(&scratch, ptr))
+		free(ptr);
 }
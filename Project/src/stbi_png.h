@@ -7,8 +7,14 @@
  *	Based on: https://github.com/nothings/stb/blob/master/stb_image.h
  */
 
+#define STBI_SCRATCH_SLACK	(64 << 10)	/**< Room for decoding's small allocations, past its buffers */
+
 /**
  *	@brief Loads PNG image, returning it
+ *
+ *	Decoding allocates from a scratch arena sized from the image's header,
+ *	which grows to the largest image decoded so far. Whatever doesn't fit
+ *	in it is allocated from the heap.
  *	@param width Loaded image's width
  *	@param height Loaded image's height
  *	@param image_path PNG image path
@@ -21,4 +27,12 @@ unsigned char* stbi_png_load(int* width, int* height, const char* image_path);
  */
 void stbi_free(unsigned char* image);
 
+/**
+ *	@brief Frees the memory kept for decoding, printing its high-water mark
+ *
+ *	On host builds, only the calling thread's memory is freed: worker threads
+ *	must call it before they finish.
+ */
+void stbi_png_cleanup();
+
 #endif /* __STBI_PNG_H */
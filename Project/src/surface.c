@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "surface.h"
+
+/* masks selecting the even and odd bytes of a 32-bit word */
+#define EVEN_BYTES	0x00ff00ffUL
+#define ODD_BYTES	0xff00ff00UL
+
+#define PALETTE_HASH_BITS	10			/* palette's hash table has 1024 slots */
+#define PALETTE_EMPTY		0xffffffff	/* hash table's free slot, not an RGB color */
+
+Surface* surface_create(int width, int height) {
+
+	Surface* surface = (Surface *) malloc(sizeof(Surface));
+	if (surface == NULL)
+		return NULL;
+
+	surface->width = width;
+	surface->height = height;
+	surface->pitch = width * SURFACE_BYTES_PER_PIXEL;
+	surface->pixels = (char *) malloc(surface->pitch * height);
+	if (surface->pixels == NULL) {
+		free(surface);
+		return NULL;
+	}
+
+	return surface;
+}
+
+Surface* surface_create_arena(Arena* arena, int width, int height) {
+
+	size_t pitch = width * SURFACE_BYTES_PER_PIXEL;
+	Surface* surface = (Surface *) arena_alloc(arena, sizeof(Surface) + pitch * height);
+	if (surface == NULL)
+		return NULL;
+
+	surface->width = width;
+	surface->height = height;
+	surface->pitch = pitch;
+	surface->pixels = (char *) (surface + 1);
+	return surface;
+}
+
+void surface_destroy(Surface* surface) {
+
+	if (surface == NULL)
+		return;
+
+	free(surface->pixels);
+	free(surface);
+}
+
+void surface_put_pixel(Surface* surface, int x, int y, uint32_t color) {
+
+	char* pixel = surface->pixels + y * surface->pitch + x * SURFACE_BYTES_PER_PIXEL;
+
+	pixel[0] = color & 0xff;
+	pixel[1] = (color >> 8) & 0xff;
+	pixel[2] = (color >> 16) & 0xff;
+}
+
+uint32_t surface_get_pixel(const Surface* surface, int x, int y) {
+
+	const unsigned char* pixel = (const unsigned char *) surface->pixels
+			+ y * surface->pitch + x * SURFACE_BYTES_PER_PIXEL;
+
+	return pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+}
+
+/** Clips a blit's rectangle to the destination, returning 0 if nothing's left */
+static int surface_clip(const Surface* dst, int* src_x, int* src_y, int* width,
+		int* height, int* dst_x, int* dst_y) {
+
+	if (*dst_x < 0) {
+		*src_x -= *dst_x;
+		*width += *dst_x;
+		*dst_x = 0;
+	}
+	if (*dst_y < 0) {
+		*src_y -= *dst_y;
+		*height += *dst_y;
+		*dst_y = 0;
+	}
+	if (*dst_x + *width > dst->width)
+		*width = dst->width - *dst_x;
+	if (*dst_y + *height > dst->height)
+		*height = dst->height - *dst_y;
+
+	return *width > 0 && *height > 0;
+}
+
+void surface_blit(Surface* dst, const Surface* src, int src_x, int src_y,
+		int width, int height, int dst_x, int dst_y) {
+
+	if (!surface_clip(dst, &src_x, &src_y, &width, &height, &dst_x, &dst_y))
+		return;
+
+	char* d = dst->pixels + dst_y * dst->pitch + dst_x * SURFACE_BYTES_PER_PIXEL;
+	const char* s = src->pixels + src_y * src->pitch + src_x * SURFACE_BYTES_PER_PIXEL;
+	size_t n_bytes = width * SURFACE_BYTES_PER_PIXEL;
+
+	int row;
+	for (row = 0; row < height; row++, d += dst->pitch, s += src->pitch)
+		memcpy(d, s, n_bytes);
+}
+
+void surface_copy(Surface* dst, const Surface* src, int x, int y, int width, int height) {
+
+	size_t offset = y * dst->pitch + x * SURFACE_BYTES_PER_PIXEL;
+	size_t n_bytes = width * SURFACE_BYTES_PER_PIXEL;
+
+	int row;
+	for (row = 0; row < height; row++, offset += dst->pitch)
+		memcpy(dst->pixels + offset, src->pixels + offset, n_bytes);
+}
+
+/** Interpolates 4 packed bytes: each 8-bit lane is widened to 16 bits
+ * by splitting even and odd bytes, so a single multiply handles 2 lanes */
+static uint32_t lerp4(uint32_t a, uint32_t b, uint32_t alpha) {
+
+	uint32_t inv = 256 - alpha;
+	uint32_t even = ((a & EVEN_BYTES) * inv + (b & EVEN_BYTES) * alpha) >> 8;
+	uint32_t odd = ((a >> 8) & EVEN_BYTES) * inv + ((b >> 8) & EVEN_BYTES) * alpha;
+
+	return (even & EVEN_BYTES) | (odd & ODD_BYTES);
+}
+
+void surface_lerp(Surface* dst, const Surface* a, const Surface* b, unsigned int alpha,
+		int x, int y, int width, int height) {
+
+	size_t offset = y * dst->pitch + x * SURFACE_BYTES_PER_PIXEL;
+	size_t n_bytes = width * SURFACE_BYTES_PER_PIXEL;
+	size_t n_words = n_bytes / 4;
+
+	int row;
+	for (row = 0; row < height; row++, offset += dst->pitch) {
+		char* d = dst->pixels + offset;
+		const char* pa = a->pixels + offset;
+		const char* pb = b->pixels + offset;
+
+		/* rows aren't word-aligned, so words are loaded with memcpy */
+		size_t i;
+		for (i = 0; i < n_words; i++) {
+			uint32_t wa, wb, wd;
+			memcpy(&wa, pa + i * 4, 4);
+			memcpy(&wb, pb + i * 4, 4);
+			wd = lerp4(wa, wb, alpha);
+			memcpy(d + i * 4, &wd, 4);
+		}
+
+		/* remaining bytes */
+		for (i = n_words * 4; i < n_bytes; i++) {
+			unsigned int ba = (unsigned char) pa[i];
+			unsigned int bb = (unsigned char) pb[i];
+			d[i] = (ba * (256 - alpha) + bb * alpha) >> 8;
+		}
+	}
+}
+
+int surface_diff_rect(const Surface* a, const Surface* b, int* x, int* y, int* width, int* height) {
+
+	int min_x = a->width, max_x = -1;
+	int min_y = a->height, max_y = -1;
+
+	int row;
+	for (row = 0; row < a->height; row++) {
+		const char* pa = a->pixels + row * a->pitch;
+		const char* pb = b->pixels + row * b->pitch;
+
+		if (memcmp(pa, pb, a->pitch) == 0)
+			continue;
+
+		if (row < min_y)
+			min_y = row;
+		max_y = row;
+
+		/* narrow the columns from both ends of the row */
+		int left = 0, right = a->pitch - 1;
+		while (left < min_x * SURFACE_BYTES_PER_PIXEL && pa[left] == pb[left])
+			left++;
+		while (right > max_x * SURFACE_BYTES_PER_PIXEL && pa[right] == pb[right])
+			right--;
+
+		if (left / SURFACE_BYTES_PER_PIXEL < min_x)
+			min_x = left / SURFACE_BYTES_PER_PIXEL;
+		if (right / SURFACE_BYTES_PER_PIXEL > max_x)
+			max_x = right / SURFACE_BYTES_PER_PIXEL;
+	}
+
+	if (max_y < 0)
+		return 0;
+
+	*x = min_x;
+	*y = min_y;
+	*width = max_x - min_x + 1;
+	*height = max_y - min_y + 1;
+	return 1;
+}
+
+/** Looks a color up in a palette's hash table, adding it if missing,
+ * returning its index or -1 once the palette is full */
+static int palette_lookup(uint32_t* keys, uint8_t* values, unsigned int* n_colors,
+		uint8_t* palette, uint32_t color) {
+
+	/* multiplicative hashing, linear probing */
+	uint32_t slot = (color * 2654435761u) >> (32 - PALETTE_HASH_BITS);
+	while (keys[slot] != color && keys[slot] != PALETTE_EMPTY)
+		slot = (slot + 1) & ((1 << PALETTE_HASH_BITS) - 1);
+
+	if (keys[slot] == PALETTE_EMPTY) {
+		if (*n_colors == INDEXED_COLORS)
+			return -1;
+
+		keys[slot] = color;
+		values[slot] = *n_colors;
+		palette[*n_colors * SURFACE_BYTES_PER_PIXEL] = color & 0xff;
+		palette[*n_colors * SURFACE_BYTES_PER_PIXEL + 1] = (color >> 8) & 0xff;
+		palette[*n_colors * SURFACE_BYTES_PER_PIXEL + 2] = (color >> 16) & 0xff;
+		(*n_colors)++;
+	}
+
+	return values[slot];
+}
+
+IndexedSurface* surface_index(const Surface* src, Arena* arena, int lossy) {
+
+	/* colors are truncated further until they fit in the palette */
+	static const uint32_t masks[] = { 0xffffff, 0xfefefe, 0xfcfcfc, 0xf8f8f8,
+			0xf0f0f0, 0xe0e0e0, 0xc0c0c0 };
+	uint32_t keys[1 << PALETTE_HASH_BITS];
+	uint8_t values[1 << PALETTE_HASH_BITS];
+
+	size_t size = sizeof(IndexedSurface) + INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL
+			+ (size_t) src->width * src->height;
+	IndexedSurface* indexed = (IndexedSurface *) (arena != NULL
+			? arena_alloc(arena, size) : malloc(size));
+	if (indexed == NULL)
+		return NULL;
+
+	indexed->width = src->width;
+	indexed->height = src->height;
+	indexed->pitch = src->width;
+	indexed->palette = (uint8_t *) (indexed + 1);
+	indexed->indices = indexed->palette + INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL;
+
+	size_t m;
+	for (m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+		if (m > 0 && !lossy)
+			break;
+
+		memset(keys, 0xff, sizeof(keys));
+		memset(indexed->palette, 0, INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL);
+		indexed->n_colors = 0;
+
+		int x, y, full = 0;
+		for (y = 0; y < src->height && !full; y++) {
+			uint8_t* index = indexed->indices + y * indexed->pitch;
+			for (x = 0; x < src->width; x++) {
+				int i = palette_lookup(keys, values, &indexed->n_colors,
+						indexed->palette, surface_get_pixel(src, x, y) & masks[m]);
+				if (i < 0) {
+					full = 1;
+					break;
+				}
+				index[x] = i;
+			}
+		}
+
+		if (!full)
+			return indexed;
+	}
+
+	if (arena == NULL)
+		free(indexed);
+	return NULL;
+}
+
+void indexed_destroy(IndexedSurface* surface) {
+
+	/* palette and indices share the surface's allocation */
+	free(surface);
+}
+
+uint32_t indexed_get_pixel(const IndexedSurface* surface, int x, int y) {
+
+	const uint8_t* color = surface->palette
+			+ surface->indices[y * surface->pitch + x] * SURFACE_BYTES_PER_PIXEL;
+
+	return color[0] | (color[1] << 8) | (color[2] << 16);
+}
+
+void indexed_blit(Surface* dst, const IndexedSurface* src, int src_x, int src_y,
+		int width, int height, int dst_x, int dst_y) {
+
+	if (!surface_clip(dst, &src_x, &src_y, &width, &height, &dst_x, &dst_y))
+		return;
+
+	char* d = dst->pixels + dst_y * dst->pitch + dst_x * SURFACE_BYTES_PER_PIXEL;
+	const uint8_t* s = src->indices + src_y * src->pitch + src_x;
+
+	/* the palette is the lookup table from indices to native pixels */
+	int row, col;
+	for (row = 0; row < height; row++, d += dst->pitch, s += src->pitch) {
+		char* pixel = d;
+		for (col = 0; col < width; col++, pixel += SURFACE_BYTES_PER_PIXEL) {
+			const uint8_t* color = src->palette + s[col] * SURFACE_BYTES_PER_PIXEL;
+			pixel[0] = color[0];
+			pixel[1] = color[1];
+			pixel[2] = color[2];
+		}
+	}
+}
+
+int indexed_diff_rect(const IndexedSurface* a, const Surface* b, int* x, int* y,
+		int* width, int* height) {
+
+	int min_x = a->width, max_x = -1;
+	int min_y = a->height, max_y = -1;
+
+	int row, col;
+	for (row = 0; row < a->height; row++) {
+		for (col = 0; col < a->width; col++) {
+			if (indexed_get_pixel(a, col, row) == surface_get_pixel(b, col, row))
+				continue;
+
+			if (col < min_x)
+				min_x = col;
+			if (col > max_x)
+				max_x = col;
+			if (row < min_y)
+				min_y = row;
+			max_y = row;
+		}
+	}
+
+	if (max_y < 0)
+		return 0;
+
+	*x = min_x;
+	*y = min_y;
+	*width = max_x - min_x + 1;
+	*height = max_y - min_y + 1;
+	return 1;
+}
@@ -0,0 +1,237 @@
+#ifndef __SURFACE_H
+#define __SURFACE_H
+
+#include <stdint.h>
+#include "arena.h"
+
+/**
+ * @file surface.h
+ */
+
+/**
+ *	@defgroup Surface
+ *	@{
+ *
+ *	Off-screen pixel buffers stored in the framebuffer's native format
+ *	(BGR, 3 bytes per pixel), so they can be copied to the double buffer
+ *	without any per-pixel conversion
+ */
+
+#define SURFACE_BYTES_PER_PIXEL	3	/**< Bytes per pixel of the native format */
+#define INDEXED_COLORS			256	/**< Maximum number of colors of an indexed surface */
+
+/**
+ * @brief Native-format pixel buffer
+*/
+typedef struct Surface {
+	int width;			/**< Surface's width in pixels */
+	int height;			/**< Surface's height in pixels */
+	int pitch;			/**< Surface's row size in bytes */
+	char* pixels;		/**< Surface's pixels, in native format */
+} Surface;
+
+/**
+ * @brief Palette-indexed pixel buffer, 1 byte per pixel
+*/
+typedef struct IndexedSurface {
+	int width;				/**< Surface's width in pixels */
+	int height;				/**< Surface's height in pixels */
+	int pitch;				/**< Surface's row size in bytes */
+	unsigned int n_colors;	/**< Number of colors used */
+	uint8_t* palette;		/**< INDEXED_COLORS colors, in native format */
+	uint8_t* indices;		/**< Surface's pixels, as palette indices */
+} IndexedSurface;
+
+/**
+ *  @brief Surface creator
+ *
+ * 	Allocates a surface with the given dimensions. Its pixels are
+ * 	left uninitialized.
+ *
+ *	@param width Surface's width
+ *	@param height Surface's height
+ *	@return Returns pointer to the created surface, NULL on failure
+ */
+Surface* surface_create(int width, int height);
+
+/**
+ *  @brief Surface creator, allocating from an arena
+ *
+ * 	Same as surface_create(), but the surface and its pixels are allocated
+ * 	contiguously from the arena. Such a surface mustn't be destroyed: it's
+ * 	freed along with the arena.
+ *
+ *	@param arena Arena to allocate from
+ *	@param width Surface's width
+ *	@param height Surface's height
+ *	@return Returns pointer to the created surface, NULL if the arena is full
+ */
+Surface* surface_create_arena(Arena* arena, int width, int height);
+
+/**
+ *  @brief Surface destroyer
+ *
+ * 	Destroys the surface, freeing all memory allocated to it.
+ *
+ *	@param surface Surface to be destroyed
+ */
+void surface_destroy(Surface* surface);
+
+/**
+ *  @brief Sets a surface's pixel
+ *
+ *	@param surface Surface to draw on
+ *	@param x Pixel's x coordinate
+ *	@param y Pixel's y coordinate
+ *	@param color RGB color to set
+ */
+void surface_put_pixel(Surface* surface, int x, int y, uint32_t color);
+
+/**
+ *  @brief Reads a surface's pixel
+ *
+ *	@param surface Surface to read from
+ *	@param x Pixel's x coordinate
+ *	@param y Pixel's y coordinate
+ *	@return Returns the pixel's RGB color
+ */
+uint32_t surface_get_pixel(const Surface* surface, int x, int y);
+
+/**
+ *  @brief Draws a rectangle from a surface onto another
+ *
+ * 	Copies the rectangle with left-upper corner (src_x,src_y) from src to
+ * 	position (dst_x,dst_y) in dst, clipping it to dst's dimensions.
+ *
+ *	@param dst Destination surface
+ *	@param src Source surface
+ *	@param src_x Rectangle's left-upper corner x coordinate in src
+ *	@param src_y Rectangle's left-upper corner y coordinate in src
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ *	@param dst_x Rectangle's left-upper corner x coordinate in dst
+ *	@param dst_y Rectangle's left-upper corner y coordinate in dst
+ */
+void surface_blit(Surface* dst, const Surface* src, int src_x, int src_y,
+		int width, int height, int dst_x, int dst_y);
+
+/**
+ *  @brief Copies a rectangle between two surfaces
+ *
+ * 	Copies the rectangle with left-upper corner (x,y) from src to the
+ * 	same position in dst. Both surfaces must have the same dimensions.
+ *
+ *	@param dst Destination surface
+ *	@param src Source surface
+ *	@param x Rectangle's left-upper corner x coordinate
+ *	@param y Rectangle's left-upper corner y coordinate
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ */
+void surface_copy(Surface* dst, const Surface* src, int x, int y, int width, int height);
+
+/**
+ *  @brief Blends two surfaces into a third one
+ *
+ * 	Linearly interpolates every byte inside the given rectangle between
+ * 	surfaces "a" and "b", storing the result in dst. The kernel works on
+ * 	four bytes at a time, packed in a 32-bit word (SIMD within a register).
+ * 	All three surfaces must have the same dimensions.
+ *
+ *	@param dst Destination surface
+ *	@param a Surface shown when alpha is 0
+ *	@param b Surface shown when alpha is 256
+ *	@param alpha Blending factor, ranging from 0 to 256
+ *	@param x Rectangle's left-upper corner x coordinate
+ *	@param y Rectangle's left-upper corner y coordinate
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ */
+void surface_lerp(Surface* dst, const Surface* a, const Surface* b, unsigned int alpha,
+		int x, int y, int width, int height);
+
+/**
+ *  @brief Computes the area where two surfaces differ
+ *
+ * 	Finds the smallest rectangle containing every pixel that differs
+ * 	between both surfaces, which must have the same dimensions.
+ *
+ *	@param a First surface
+ *	@param b Second surface
+ *	@param x Rectangle's left-upper corner x coordinate
+ *	@param y Rectangle's left-upper corner y coordinate
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ *	@return Returns 0 if the surfaces are equal and 1 otherwise
+ */
+int surface_diff_rect(const Surface* a, const Surface* b, int* x, int* y, int* width, int* height);
+
+/**
+ *  @brief Converts a surface into an indexed surface
+ *
+ * 	The surface's colors become the palette. With more than INDEXED_COLORS
+ * 	colors, the surface is either rejected or quantized, truncating its
+ * 	colors' lowest bits until they fit.
+ *
+ *	@param src Surface to be converted
+ *	@param arena Arena to allocate from, NULL for the heap
+ *	@param lossy Whether colors may be quantized
+ *	@return Returns pointer to the indexed surface, NULL on failure
+ */
+IndexedSurface* surface_index(const Surface* src, Arena* arena, int lossy);
+
+/**
+ *  @brief Indexed surface destroyer
+ *
+ * 	Only for indexed surfaces allocated from the heap.
+ *
+ *	@param surface Indexed surface to be destroyed
+ */
+void indexed_destroy(IndexedSurface* surface);
+
+/**
+ *  @brief Reads an indexed surface's pixel
+ *
+ *	@param surface Indexed surface to read from
+ *	@param x Pixel's x coordinate
+ *	@param y Pixel's y coordinate
+ *	@return Returns the pixel's RGB color
+ */
+uint32_t indexed_get_pixel(const IndexedSurface* surface, int x, int y);
+
+/**
+ *  @brief Draws a rectangle from an indexed surface onto a surface
+ *
+ * 	Same as surface_blit(), expanding each index through the palette.
+ *
+ *	@param dst Destination surface
+ *	@param src Source indexed surface
+ *	@param src_x Rectangle's left-upper corner x coordinate in src
+ *	@param src_y Rectangle's left-upper corner y coordinate in src
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ *	@param dst_x Rectangle's left-upper corner x coordinate in dst
+ *	@param dst_y Rectangle's left-upper corner y coordinate in dst
+ */
+void indexed_blit(Surface* dst, const IndexedSurface* src, int src_x, int src_y,
+		int width, int height, int dst_x, int dst_y);
+
+/**
+ *  @brief Computes the area where an indexed surface and a surface differ
+ *
+ * 	Same as surface_diff_rect(), comparing the indexed surface's colors.
+ *
+ *	@param a Indexed surface
+ *	@param b Surface
+ *	@param x Rectangle's left-upper corner x coordinate
+ *	@param y Rectangle's left-upper corner y coordinate
+ *	@param width Rectangle's width
+ *	@param height Rectangle's height
+ *	@return Returns 0 if the surfaces are equal and 1 otherwise
+ */
+int indexed_diff_rect(const IndexedSurface* a, const Surface* b, int* x, int* y,
+		int* width, int* height);
+
+/**@}*/
+
+#endif /* __SURFACE_H */
@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "transition.h"
+#include "video_gr.h"
+
+Transition* initialize_transition(int width, int height) {
+
+	Transition* transition = (Transition *) malloc(sizeof(Transition));
+	if (transition == NULL)
+		return NULL;
+
+	transition->from = surface_create(width, height);
+	transition->to = surface_create(width, height);
+	if (transition->from == NULL || transition->to == NULL) {
+		destroy_transition(transition);
+		return NULL;
+	}
+
+	transition->frame = 0;
+	transition->n_frames = 0;
+	return transition;
+}
+
+void destroy_transition(Transition* transition) {
+
+	if (transition == NULL)
+		return;
+
+	surface_destroy(transition->from);
+	surface_destroy(transition->to);
+	free(transition);
+}
+
+int transition_start(Transition* transition, transition_type_t type, unsigned int n_frames) {
+
+	transition->type = type;
+	transition->frame = 0;
+	transition->n_frames = n_frames;
+
+	/* only the area where both screens differ needs to be animated */
+	if (!surface_diff_rect(transition->from, transition->to, &transition->x,
+			&transition->y, &transition->width, &transition->height)) {
+		transition->n_frames = 0;
+		return 0;
+	}
+
+	/* the double buffer must hold the first screen while the other one is revealed */
+	surface_copy(vg_back_buffer(), transition->from, transition->x, transition->y,
+			transition->width, transition->height);
+
+	return 1;
+}
+
+int transition_step(Transition* transition) {
+
+	if (transition->frame >= transition->n_frames)
+		return 0;
+
+	transition->frame++;
+
+	if (transition->type == CROSSFADE) {
+		unsigned int alpha = (transition->frame << 8) / transition->n_frames;
+		surface_lerp(vg_back_buffer(), transition->from, transition->to, alpha,
+				transition->x, transition->y, transition->width, transition->height);
+		vg_copy_rect(transition->x, transition->y, transition->width,
+				transition->height);
+	} else {
+		/* reveals the columns between the last and the current edge */
+		int last_edge = (transition->frame - 1) * transition->width / transition->n_frames;
+		int edge = transition->frame * transition->width / transition->n_frames;
+		surface_copy(vg_back_buffer(), transition->to, transition->x + last_edge,
+				transition->y, edge - last_edge, transition->height);
+		vg_copy_rect(transition->x + last_edge, transition->y, edge - last_edge,
+				transition->height);
+	}
+
+	return transition->frame < transition->n_frames;
+}
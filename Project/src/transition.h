@@ -0,0 +1,89 @@
+#ifndef __TRANSITION_H
+#define __TRANSITION_H
+
+#include "surface.h"
+
+/**
+ * @file transition.h
+ */
+
+/**
+ *	@defgroup Transition
+ *	@{
+ *
+ *	Animated transitions between two screens, advanced one frame per
+ *	timer tick so the event loop keeps running while they play
+ */
+
+#define CROSSFADE_FRAMES	30	/**< Crossfade's duration in timer ticks */
+#define WIPE_FRAMES			20	/**< Wipe's duration in timer ticks */
+
+/**
+ * @brief Transition types
+*/
+typedef enum { CROSSFADE, WIPE } transition_type_t;
+
+/**
+ * @brief Screen transition
+*/
+typedef struct Transition {
+	transition_type_t type;		/**< Transition's type */
+	Surface* from;				/**< Screen shown when the transition starts */
+	Surface* to;				/**< Screen shown when the transition ends */
+	unsigned int frame;			/**< Transition's current frame */
+	unsigned int n_frames;		/**< Transition's number of frames */
+	int x;						/**< Changing area's left-upper corner x coordinate */
+	int y;						/**< Changing area's left-upper corner y coordinate */
+	int width;					/**< Changing area's width */
+	int height;					/**< Changing area's height */
+} Transition;
+
+/**
+ *  @brief Transition initializer
+ *
+ * 	Allocates a transition along with its two screen-sized surfaces,
+ * 	which are reused by every transition played afterwards.
+ *
+ *	@param width Screen's width
+ *	@param height Screen's height
+ *	@return Returns pointer to the transition, NULL on failure
+ */
+Transition* initialize_transition(int width, int height);
+
+/**
+ *  @brief Transition destroyer
+ *
+ * 	Destroys the transition, freeing all memory allocated to it.
+ *
+ *	@param transition Transition to be destroyed, may be NULL
+ */
+void destroy_transition(Transition* transition);
+
+/**
+ *  @brief Starts a transition
+ *
+ * 	Starts a transition from surface "from" to surface "to", which must
+ * 	have been filled by the caller. Only the area where both screens
+ * 	differ is animated and presented.
+ *
+ *	@param transition Transition to start
+ *	@param type Transition's type
+ *	@param n_frames Transition's number of frames
+ *	@return Returns 0 if there is nothing to animate and 1 otherwise
+ */
+int transition_start(Transition* transition, transition_type_t type, unsigned int n_frames);
+
+/**
+ *  @brief Advances a transition by one frame
+ *
+ * 	Draws the transition's next frame on the double buffer and presents
+ * 	the area that changed.
+ *
+ *	@param transition Transition to advance
+ *	@return Returns 1 while the transition is running and 0 when it has ended
+ */
+int transition_step(Transition* transition);
+
+/**@}*/
+
+#endif /* __TRANSITION_H */
@@ -45,3 +45,60 @@ int vbe_get_mode_info(unsigned short mode, vbe_mode_info_t* vmi_p) {
 	lm_free(&video_buf);
 	return 0;
 }
+
+unsigned int vbe_set_dac_width(unsigned int bits) {
+
+	struct reg86u r;
+
+	r.u.w.ax = 0x4F08;		/* VBE set/get DAC palette format */
+	r.u.b.bl = 0x00;		/* set format */
+	r.u.b.bh = bits;
+	r.u.b.intno = 0x10;
+
+	if (sys_int86(&r) != OK || r.u.w.ax != 0x004F)
+		return 6;
+
+	return r.u.b.bh;
+}
+
+int vbe_set_palette(const uint8_t* colors, unsigned int first, unsigned int n_colors,
+		unsigned int dac_bits) {
+
+	struct reg86u r;
+	mmap_t palette_buf;
+	unsigned int i, shift = 8 - dac_bits;
+
+	if (lm_init() == NULL) {
+		printf("Error calling lm_init()!\n");
+		return 1;
+	}
+
+	/* entries are blue, green, red and an alignment byte */
+	uint8_t* entries = (uint8_t *) lm_alloc(n_colors * 4, &palette_buf);
+	if (entries == NULL) {
+		printf("Error calling lm_alloc()!\n");
+		return 1;
+	}
+
+	for (i = 0; i < n_colors; i++) {
+		entries[i * 4] = colors[i * 3] >> shift;
+		entries[i * 4 + 1] = colors[i * 3 + 1] >> shift;
+		entries[i * 4 + 2] = colors[i * 3 + 2] >> shift;
+		entries[i * 4 + 3] = 0;
+	}
+
+	r.u.w.ax = 0x4F09;		/* VBE set/get palette data */
+	r.u.b.bl = 0x00;		/* set primary palette */
+	r.u.w.cx = n_colors;
+	r.u.w.dx = first;
+	r.u.w.es = PB2BASE(palette_buf.phys);
+	r.u.w.di = PB2OFF(palette_buf.phys);
+	r.u.b.intno = 0x10;
+
+	int failed = sys_int86(&r) != OK || r.u.w.ax != 0x004F;
+	if (failed)
+		printf("Error calling vbe_set_palette(): sys_int86() failed!\n");
+
+	lm_free(&palette_buf);
+	return failed;
+}
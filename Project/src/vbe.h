@@ -68,4 +68,28 @@ typedef struct {
 
 int vbe_get_mode_info(unsigned short mode, vbe_mode_info_t* vmi_p);
 
+/**
+ * @brief Sets the DAC's width, in bits per color component
+ *
+ * Uses VBE function 0x4F08. DACs that can't switch stay at 6 bits.
+ *
+ * @param bits Desired width, 6 or 8
+ * @return Returns the width the DAC was left with
+ */
+unsigned int vbe_set_dac_width(unsigned int bits);
+
+/**
+ * @brief Programs palette entries of an indexed mode
+ *
+ * Uses VBE function 0x4F09, with the colors reduced to the DAC's width.
+ *
+ * @param colors Colors, in native format (BGR, 3 bytes each)
+ * @param first First palette entry to set
+ * @param n_colors Number of entries to set
+ * @param dac_bits DAC's width, as returned by vbe_set_dac_width()
+ * @return Returns 0 upon success, non-zero otherwise
+ */
+int vbe_set_palette(const uint8_t* colors, unsigned int first, unsigned int n_colors,
+		unsigned int dac_bits);
+
 #endif /* __VBE_H */
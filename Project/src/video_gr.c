@@ -3,9 +3,13 @@
 #include <machine/int86.h>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <limits.h>
 #include "video_gr.h"
 #include "lmlib.h"
 #include "vbe.h"
+#include "atlas.h"
+#include "glyph.h"
+#include "profile.h"
 
 static phys_bytes video_phys;	/*< VRAM's physical address */
 static char* video_mem;			/*< VRAM's virtual address */
@@ -14,6 +18,92 @@ static char* double_buffer;		/*< DOUBLE-BUFFER's virtual address */
 static uint16_t h_res;			/**< Screen's horizontal resolution in pixels */
 static uint16_t v_res;			/**< Screen's vertical resolution in pixels */
 static uint8_t bits_per_pixel; 	/**< Number of bits per pixel */
+static Surface back_buffer;		/**< DOUBLE-BUFFER seen as a surface */
+
+static uint8_t palette[VG_PALETTE_COLORS * SURFACE_BYTES_PER_PIXEL];	/**< Indexed modes' palette, native format */
+static unsigned int n_fixed;	/**< Palette entries not adapted to the assets */
+static unsigned int dac_bits;	/**< DAC's width, in bits per color component */
+static uint8_t* present_lut;	/**< Palette entry of every 15-bit color, indexed modes only */
+static uint32_t* gather_counts;	/**< Pixels gathered of every 15-bit color, NULL until some are */
+static uint8_t* gather_colors;	/**< First color gathered of every 15-bit color, native format */
+
+/** Colors the game fills areas with, kept exact in indexed modes */
+static const uint32_t fixed_colors[] = { BORDER_COLOR, SNAKE_COLOR, GRASS_COLOR,
+		MOUSE_BG_COLOR, LETTER_BORDER_COLOR };
+
+/** Returns a color's distance to a palette entry */
+static unsigned int vg_palette_distance(const uint8_t* entry, int b, int g, int r) {
+
+	int db = entry[0] - b, dg = entry[1] - g, dr = entry[2] - r;
+	return db * db + dg * dg + dr * dr;
+}
+
+/** Returns a native color's 15-bit color, the present's lookup index */
+static unsigned int vg_color15(const uint8_t* color) {
+
+	return (color[0] >> 3) | ((color[1] >> 3) << 5) | ((color[2] >> 3) << 10);
+}
+
+/** Returns the color cube's entry nearest to a color, rounding each component on its own */
+static unsigned int vg_cube_nearest(int b, int g, int r) {
+
+	return ((r + 25) / 51) * 36 + ((g + 25) / 51) * 6 + (b + 25) / 51;
+}
+
+/** Maps every 15-bit color to its nearest palette entry */
+static void vg_build_lut() {
+
+	unsigned int color, i;
+	for (color = 0; color < (1 << 15); color++) {
+		/* 5-bit components widened, low bits copying the high ones */
+		int b = ((color & 0x1f) << 3) | ((color & 0x1f) >> 2);
+		int g = (((color >> 5) & 0x1f) << 3) | (((color >> 5) & 0x1f) >> 2);
+		int r = (((color >> 10) & 0x1f) << 3) | (((color >> 10) & 0x1f) >> 2);
+
+		/* the cube's nearest entry rounds each component on its own,
+		 * the entries after the cube are searched */
+		unsigned int best = vg_cube_nearest(b, g, r);
+		unsigned int best_distance = vg_palette_distance(&palette[best * 3], b, g, r);
+		for (i = VG_PALETTE_CUBE; i < VG_PALETTE_COLORS; i++) {
+			unsigned int distance = vg_palette_distance(&palette[i * 3], b, g, r);
+			if (distance < best_distance) {
+				best = i;
+				best_distance = distance;
+			}
+		}
+
+		present_lut[color] = best;
+	}
+}
+
+/** Sets an indexed mode's palette: a 6x6x6 color cube, the fixed colors and grays */
+static int vg_init_palette() {
+
+	present_lut = (uint8_t *) malloc(1 << 15);
+	if (present_lut == NULL)
+		return 1;
+
+	unsigned int i, n = 0;
+	for (i = 0; i < VG_PALETTE_CUBE; i++, n++) {
+		palette[n * 3] = (i % 6) * 51;
+		palette[n * 3 + 1] = (i / 6 % 6) * 51;
+		palette[n * 3 + 2] = (i / 36) * 51;
+	}
+	for (i = 0; i < sizeof(fixed_colors) / sizeof(fixed_colors[0]); i++, n++) {
+		palette[n * 3] = fixed_colors[i] & 0xff;
+		palette[n * 3 + 1] = (fixed_colors[i] >> 8) & 0xff;
+		palette[n * 3 + 2] = (fixed_colors[i] >> 16) & 0xff;
+	}
+	n_fixed = n;
+
+	/* grays until the assets' own colors are adapted */
+	for (i = 0; n < VG_PALETTE_COLORS; i++, n++)
+		memset(&palette[n * 3], i * 255 / (VG_PALETTE_COLORS - n_fixed - 1), 3);
+
+	dac_bits = vbe_set_dac_width(8);
+	vg_build_lut();
+	return vbe_set_palette(palette, 0, VG_PALETTE_COLORS, dac_bits);
+}
 
 void* vg_init(unsigned short mode) {
 
@@ -24,7 +114,10 @@ void* vg_init(unsigned short mode) {
 	vbe_mode_info_t info;
 
 	/* Gets vbe mode's information */
-	if (vbe_get_mode_info(mode, &info) != 0) return NULL;
+	int phase = profile_begin("vbe_get_mode_info");
+	r = vbe_get_mode_info(mode, &info);
+	profile_end(phase);
+	if (r != 0) return NULL;
 
 	h_res = info.XResolution;
 	v_res = info.YResolution;
@@ -54,12 +147,160 @@ void* vg_init(unsigned short mode) {
 	if (video_mem == MAP_FAILED)
 		panic("vg_init: couldn't map video memory\n");
 
-	/* Allocates double buffer */
-	double_buffer = (char*) malloc(vram_size);
+	/* Allocates double buffer, native format whatever the mode */
+	double_buffer = (char*) malloc(h_res * v_res * SURFACE_BYTES_PER_PIXEL);
+
+	back_buffer.width = h_res;
+	back_buffer.height = v_res;
+	back_buffer.pitch = h_res * SURFACE_BYTES_PER_PIXEL;
+	back_buffer.pixels = double_buffer;
+
+	/* indexed modes are presented through a palette */
+	if (bits_per_pixel == 8 && vg_init_palette() != 0)
+		printf("vg_init: couldn't set the palette\n");
 
 	return video_mem;
 }
 
+/** Counts pixels of a color towards the palette, the transparent color aside */
+static void vg_gather_color(const uint8_t* color, uint32_t n_pixels) {
+
+	if (n_pixels == 0 || (color[0] == (BG_COLOR & 0xff)
+			&& color[1] == ((BG_COLOR >> 8) & 0xff) && color[2] == (BG_COLOR >> 16)))
+		return;
+
+	unsigned int color15 = vg_color15(color);
+	if (gather_counts[color15] == 0)
+		memcpy(&gather_colors[color15 * 3], color, 3);
+	gather_counts[color15] += n_pixels;
+}
+
+/** Allocates the gathered colors' histogram, 0 if there's no palette to adapt */
+static int vg_gather_init() {
+
+	if (bits_per_pixel != 8)
+		return 0;
+
+	if (gather_counts == NULL) {
+		gather_counts = (uint32_t *) calloc(1 << 15, sizeof(uint32_t));
+		gather_colors = (uint8_t *) malloc((1 << 15) * 3);
+		if (gather_counts == NULL || gather_colors == NULL) {
+			free(gather_counts);
+			free(gather_colors);
+			gather_counts = NULL;
+			gather_colors = NULL;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+void vg_palette_gather(const Surface* image) {
+
+	if (image == NULL || !vg_gather_init())
+		return;
+
+	int x, y;
+	for (y = 0; y < image->height; y++) {
+		const uint8_t* pixel = (const uint8_t *) image->pixels + y * image->pitch;
+		for (x = 0; x < image->width; x++, pixel += SURFACE_BYTES_PER_PIXEL)
+			vg_gather_color(pixel, 1);
+	}
+}
+
+void vg_palette_gather_indexed(const IndexedSurface* image) {
+
+	if (image == NULL || !vg_gather_init())
+		return;
+
+	/* pixels are counted per palette index, colors gathered once each */
+	uint32_t counts[INDEXED_COLORS];
+	memset(counts, 0, sizeof(counts));
+	int x, y;
+	for (y = 0; y < image->height; y++) {
+		const uint8_t* index = image->indices + y * image->pitch;
+		for (x = 0; x < image->width; x++)
+			counts[index[x]]++;
+	}
+
+	unsigned int i;
+	for (i = 0; i < image->n_colors; i++)
+		vg_gather_color(&image->palette[i * 3], counts[i]);
+}
+
+/** Adapts an indexed mode's free palette entries to the gathered colors */
+int vg_palette_adapt() {
+
+	if (gather_counts == NULL)
+		return 0;
+
+	/* gathered colors moved to the front, in place */
+	unsigned int n_colors = 0, i, n;
+	for (i = 0; i < (1 << 15); i++) {
+		if (gather_counts[i] == 0)
+			continue;
+		gather_counts[n_colors] = gather_counts[i];
+		memmove(&gather_colors[n_colors * 3], &gather_colors[i * 3], 3);
+		n_colors++;
+	}
+
+	/* each color's distance to its nearest entry among the fixed ones */
+	unsigned int* nearest = (unsigned int *) malloc(n_colors * sizeof(unsigned int) + 1);
+	if (nearest == NULL) {
+		vg_palette_discard();
+		return 1;
+	}
+	for (i = 0; i < n_colors; i++) {
+		const uint8_t* color = &gather_colors[i * 3];
+		nearest[i] = vg_palette_distance(&palette[vg_cube_nearest(color[0], color[1],
+				color[2]) * 3], color[0], color[1], color[2]);
+		for (n = VG_PALETTE_CUBE; n < n_fixed; n++) {
+			unsigned int distance = vg_palette_distance(&palette[n * 3], color[0],
+					color[1], color[2]);
+			if (distance < nearest[i])
+				nearest[i] = distance;
+		}
+	}
+
+	/* the color whose pixels are worst served so far takes the next entry */
+	for (n = n_fixed; n < VG_PALETTE_COLORS; n++) {
+		uint64_t worst_error = 0;
+		unsigned int worst = 0;
+		for (i = 0; i < n_colors; i++) {
+			uint64_t error = (uint64_t) nearest[i] * gather_counts[i];
+			if (error > worst_error) {
+				worst = i;
+				worst_error = error;
+			}
+		}
+		if (worst_error == 0)
+			break;
+
+		memcpy(&palette[n * 3], &gather_colors[worst * 3], 3);
+		for (i = 0; i < n_colors; i++) {
+			const uint8_t* color = &gather_colors[i * 3];
+			unsigned int distance = vg_palette_distance(&palette[n * 3], color[0],
+					color[1], color[2]);
+			if (distance < nearest[i])
+				nearest[i] = distance;
+		}
+	}
+
+	free(nearest);
+	vg_palette_discard();
+	vg_build_lut();
+	return vbe_set_palette(palette, 0, VG_PALETTE_COLORS, dac_bits);
+}
+
+void vg_palette_discard() {
+
+	free(gather_counts);
+	free(gather_colors);
+	gather_counts = NULL;
+	gather_colors = NULL;
+}
+
 int vg_exit() {
 
 	struct reg86u reg86;
@@ -85,7 +326,7 @@ void draw_pixel(uint16_t x, uint16_t y, uint32_t color) {
 	if (x >= h_res || y >= v_res || color == BG_COLOR) return;
 
 	/* calculating pixel's position */
-	vram += (y * h_res + x) * (bits_per_pixel / 8);
+	vram += (y * h_res + x) * SURFACE_BYTES_PER_PIXEL;
 
 	/* transforming in RGB */
 	*vram = color & BLUE;
@@ -114,52 +355,66 @@ void vg_print_borders() {
 	vg_drawRect(495,0,5,600, BORDER_COLOR);
 }
 
-/** Draws a png image, with left corner (x,y) */
-void vg_png(unsigned char* image, int width, int height, uint16_t start_x, uint16_t start_y) {
+/** Draws an image, with left corner (x,y) */
+void vg_surface(const Surface* image, int start_x, int start_y) {
 
-	size_t x, y;
-	for(y = 0; y < height; y++) {
-		for(x = 0; x < width; x++) {
-			uint32_t rgb[3];
-			size_t c;
-			for (c = 0; c < 3; c++)
-				rgb[c] = image[(x + y * width) * 3 + c];
-			int32_t color = ((rgb[0] << 16) & RED) | ((rgb[1] << 8) & GREEN) | (rgb[2] & BLUE);
-			draw_pixel(start_x + x, start_y + y, color);
+	surface_blit(&back_buffer, image, 0, 0, image->width, image->height,
+			start_x, start_y);
+}
+
+/** Draws an indexed image, with left corner (x,y) */
+void vg_indexed(const IndexedSurface* image, int start_x, int start_y) {
+
+	indexed_blit(&back_buffer, image, 0, 0, image->width, image->height,
+			start_x, start_y);
+}
+
+/** Draws an image, with left corner (x,y), skipping transparent pixels */
+void vg_surface_keyed(const Surface* image, int start_x, int start_y) {
+
+	int x, y;
+	for (y = 0; y < image->height; y++) {
+		for (x = 0; x < image->width; x++) {
+			draw_pixel(start_x + x, start_y + y, surface_get_pixel(image, x, y));
 		}
 	}
 }
 
-/** Draws a specified letter from a given font */
-void vg_tile(unsigned char* image, char letter, int width, int height, uint16_t start_x, uint16_t start_y) {
+/** Draws a sprite of the atlas, with left corner (x,y), skipping transparent pixels */
+void vg_sprite(int sprite, int start_x, int start_y) {
+
+	const AtlasRect* rect = atlas_rect(sprite);
+	if (rect == NULL)
+		return;
+
+	const Surface* atlas = atlas_surface();
+	int x, y;
+	for (y = 0; y < rect->height; y++) {
+		const unsigned char* pixel = (const unsigned char *) atlas->pixels
+				+ (rect->y + y) * atlas->pitch + rect->x * SURFACE_BYTES_PER_PIXEL;
+		for (x = 0; x < rect->width; x++, pixel += SURFACE_BYTES_PER_PIXEL)
+			draw_pixel(start_x + x, start_y + y,
+					pixel[0] | (pixel[1] << 8) | (pixel[2] << 16));
+	}
+}
 
-	size_t row, col;
-	size_t x, y, xi, yi;
-	size_t pos = (size_t) letter;
+/** Draws a letter's tile in the given colors, with left corner (x,y) */
+void vg_tile(const GlyphMask* glyph, uint32_t ink, uint32_t paper, uint16_t start_x,
+		uint16_t start_y) {
 
-	yi = (size_t) (pos-48) / 16;
-	xi = pos - 48 - yi * 16;
-	xi *= 16;
-	yi *= 16;
+	if (glyph == NULL)
+		return;
 
-	col = yi + 16;
-	row = xi + 16;
+	if (paper == BG_COLOR)
+		glyph_blit_keyed(&back_buffer, glyph, ink, start_x, start_y);
+	else
+		glyph_blit(&back_buffer, glyph, ink, paper, start_x, start_y);
 
-	for (y = yi; y < col; y++) {
-		for (x = xi; x < row; x++) {
-			if (x == xi || x == row - 1 || y == yi || y == col - 1) {
-				draw_pixel(start_x + (x - xi), start_y + (y - yi), LETTER_BORDER_COLOR);
-			}
-			else {
-				uint32_t rgb[3];
-				size_t c;
-				for (c = 0; c < 3; c++)
-					rgb[c] = image[(x + y * width) * 3 + c];
-				int32_t color = ((rgb[0] << 16) & RED) | ((rgb[1] << 8) & GREEN) | (rgb[2] & BLUE);
-				draw_pixel(start_x + (x - xi), start_y + (y - yi), color);
-			}
-		}
-	}
+	/* tile's border */
+	vg_drawRect(start_x, start_y, GLYPH_SIZE, 1, LETTER_BORDER_COLOR);
+	vg_drawRect(start_x, start_y + GLYPH_SIZE - 1, GLYPH_SIZE, 1, LETTER_BORDER_COLOR);
+	vg_drawRect(start_x, start_y, 1, GLYPH_SIZE, LETTER_BORDER_COLOR);
+	vg_drawRect(start_x + GLYPH_SIZE - 1, start_y, 1, GLYPH_SIZE, LETTER_BORDER_COLOR);
 }
 
 /** Clears snake's part of the screen */
@@ -188,15 +443,81 @@ void vg_cursor_clear() {
 
 /** Cleans double buffer, setting all pixels to black */
 void vg_clear() {
-	memset(double_buffer, 0, h_res * v_res * (bits_per_pixel / 8));
+	memset(double_buffer, 0, h_res * v_res * SURFACE_BYTES_PER_PIXEL);
+}
+
+/** Converts a rectangle of double_buffer to palette entries, into video_mem */
+static void vg_present_indexed(int x, int y, int width, int height) {
+
+	int row, i;
+	for (row = y; row < y + height; row++) {
+		const uint8_t* pixel = (const uint8_t *) double_buffer + row * back_buffer.pitch
+				+ x * SURFACE_BYTES_PER_PIXEL;
+		char* entry = video_mem + row * h_res + x;
+
+		/* four entries at a time, written to video memory as a single word */
+		for (i = 0; i + 4 <= width; i += 4, pixel += 4 * SURFACE_BYTES_PER_PIXEL) {
+			uint32_t entries = present_lut[vg_color15(pixel)]
+					| (uint32_t) present_lut[vg_color15(pixel + 3)] << 8
+					| (uint32_t) present_lut[vg_color15(pixel + 6)] << 16
+					| (uint32_t) present_lut[vg_color15(pixel + 9)] << 24;
+			memcpy(entry + i, &entries, sizeof(entries));
+		}
+		for (; i < width; i++, pixel += SURFACE_BYTES_PER_PIXEL)
+			entry[i] = present_lut[vg_color15(pixel)];
+	}
 }
 
 /** Copies double_buffer to video_mem */
 void vg_copy() {
-	memcpy(video_mem, double_buffer, h_res * v_res * (bits_per_pixel / 8));
+
+	if (bits_per_pixel == 8)
+		vg_present_indexed(0, 0, h_res, v_res);
+	else
+		memcpy(video_mem, double_buffer, h_res * v_res * SURFACE_BYTES_PER_PIXEL);
+}
+
+/** Copies a rectangle of double_buffer to video_mem */
+void vg_copy_rect(int x, int y, int width, int height) {
+
+	if (x < 0) {
+		width += x;
+		x = 0;
+	}
+	if (y < 0) {
+		height += y;
+		y = 0;
+	}
+	if (x + width > h_res)
+		width = h_res - x;
+	if (y + height > v_res)
+		height = v_res - y;
+	if (width <= 0 || height <= 0)
+		return;
+
+	if (bits_per_pixel == 8) {
+		vg_present_indexed(x, y, width, height);
+		return;
+	}
+
+	size_t pitch = h_res * SURFACE_BYTES_PER_PIXEL;
+	size_t offset = y * pitch + x * SURFACE_BYTES_PER_PIXEL;
+	size_t n_bytes = width * SURFACE_BYTES_PER_PIXEL;
+
+	int row;
+	for (row = 0; row < height; row++, offset += pitch)
+		memcpy(video_mem + offset, double_buffer + offset, n_bytes);
+}
+
+/** Returns double_buffer as a surface */
+Surface* vg_back_buffer() {
+	return &back_buffer;
 }
 
 /** Deallocates double buffer */
 void vg_free() {
 	free(double_buffer);
+	free(present_lut);
+	present_lut = NULL;
+	vg_palette_discard();
 }
@@ -12,12 +12,23 @@
  *	Functions for using the graphics card
  */
 
+#include "surface.h"
+#include "glyph.h"
+
 #define BIT(n) (0x01<<(n))
 
 /* Screen's resolution */
 #define H_RES             	800		/**< Screen's resolution's width */
 #define V_RES		  		600		/**< Screen's resolution's height */
 
+/* Video modes */
+#define VG_MODE_24BPP		0x115	/**< 800x600, 24-bit direct color */
+#define VG_MODE_8BPP		0x103	/**< 800x600, 8-bit indexed color */
+
+/* Indexed modes' palette */
+#define VG_PALETTE_COLORS	256		/**< Palette entries */
+#define VG_PALETTE_CUBE		216		/**< Entries of the 6x6x6 color cube, the first ones */
+
 /* brief Colors */
 #define BLACK				0x000000
 #define RED					0xff0000
@@ -37,9 +48,11 @@
  * 	Uses the VBE INT 0x10 interface to set the desired
  *  graphics mode, maps VRAM to the process' address space and
  *  initializes static global variables with the resolution of the screen,
- *  and the number of colors
+ *  and the number of colors. The double buffer is native format in every
+ *  mode: 8-bit modes get a palette, and are converted to it when presented,
+ *  so only a third of the bytes reach video memory
  *
- * @param mode 24-bit color indexed mode to set
+ * @param mode 24-bit direct color or 8-bit indexed color mode to set
  * @return Virtual address VRAM was mapped to. NULL, upon failure.
  */
 void *vg_init(unsigned short mode);
@@ -84,33 +97,65 @@ void vg_drawRect(unsigned int start_x, unsigned int start_y, unsigned int width,
 void vg_print_borders();
 
 /**
- * 	@brief Draws a png image on the screen
+ * 	@brief Draws an image on the screen
+ *
+ * 	Copies a native-format image to the double buffer, with its left-upper
+ * 	corner on (x,y), row by row.
+ *
+ * 	@param image Image to be printed on the screen
+ * 	@param start_x Image's left-upper corner x coordinate
+ * 	@param start_y Image's left-upper corner y coordinate
+ */
+void vg_surface(const Surface* image, int start_x, int start_y);
+
+/**
+ * 	@brief Draws an indexed image on the screen
  *
- * 	Draws a png image on the screen based on the (x,y) coordinates of
- * 	its left-upper corner, width and height.
+ * 	Same as vg_surface(), expanding the image's indices through its palette.
  *
- * 	@param image PNG image to be printed on the screen
- * 	@param width Image's width
- * 	@param height Image's height
+ * 	@param image Indexed image to be printed on the screen
  * 	@param start_x Image's left-upper corner x coordinate
  * 	@param start_y Image's left-upper corner y coordinate
  */
-void vg_png(unsigned char* image, int width, int height, uint16_t start_x, uint16_t start_y);
+void vg_indexed(const IndexedSurface* image, int start_x, int start_y);
 
 /**
- * 	@brief Draws a tile from the "font.png" image on the screen
+ * 	@brief Draws an image with transparency on the screen
  *
- * 	Draws a letter tile on the screen, based on the required letter,
- *	the width and height of the "font.png" image, and the (x,y) coordinates
- *	where to print it.
+ * 	Same as vg_surface(), but pixels with color BG_COLOR are skipped.
  *
- * 	@param image PNG image to print tiles from ("font.png")
- * 	@param width Image's width
- * 	@param height Image's height
+ * 	@param image Image to be printed on the screen
+ * 	@param start_x Image's left-upper corner x coordinate
+ * 	@param start_y Image's left-upper corner y coordinate
+ */
+void vg_surface_keyed(const Surface* image, int start_x, int start_y);
+
+/**
+ * 	@brief Draws a sprite of the atlas on the screen
+ *
+ * 	Pixels with color BG_COLOR are skipped.
+ *
+ * 	@param sprite Sprite's id in the atlas
+ * 	@param start_x Sprite's left-upper corner x coordinate
+ * 	@param start_y Sprite's left-upper corner y coordinate
+ */
+void vg_sprite(int sprite, int start_x, int start_y);
+
+/**
+ * 	@brief Draws a letter's tile on the screen
+ *
+ * 	Expands the letter's glyph mask in the given colors, framed by a
+ * 	LETTER_BORDER_COLOR border, at the (x,y) coordinates where to print it.
+ * 	A BG_COLOR paper leaves the uncovered pixels untouched.
+ *
+ * 	@param glyph Letter's glyph mask
+ * 	@param ink Covered pixels' RGB color
+ * 	@param paper Uncovered pixels' RGB color
  * 	@param start_x Tile's left-upper corner x coordinate
  * 	@param start_y Tile's left-upper corner y coordinate
  */
-void vg_tile(unsigned char* image, char letter, int width, int height, uint16_t start_x, uint16_t start_y);
+void vg_tile(const GlyphMask* glyph, uint32_t ink, uint32_t paper, uint16_t start_x,
+		uint16_t start_y);
 
 /**
  * 	@brief Clears snake's left part of the playable screen
@@ -135,14 +180,73 @@ void vg_clear();
 
 /**
  * 	@brief Copies double_buffer memory to video_mem
+ *
+ * 	In 8-bit modes, pixels are converted to their nearest palette entry.
  */
 void vg_copy();
 
+/**
+ * 	@brief Copies a rectangle of double_buffer memory to video_mem
+ *
+ * 	Presents only the given area of the screen, which is clipped to the
+ * 	screen's resolution.
+ *
+ * 	@param x Rectangle's left-upper corner x coordinate
+ * 	@param y Rectangle's left-upper corner y coordinate
+ * 	@param width Rectangle's width
+ * 	@param height Rectangle's height
+ */
+void vg_copy_rect(int x, int y, int width, int height);
+
+/**
+ * 	@brief Returns the double buffer as a surface
+ *
+ * 	Allows surface operations to draw straight into double_buffer memory.
+ *
+ * 	@return Returns pointer to the double buffer's surface
+ */
+Surface* vg_back_buffer();
+
 /**
  * 	@brief Deallocates double_buffer memory
  */
 void vg_free();
 
+/**
+ * 	@brief Gathers an asset's colors for an 8-bit mode's palette
+ *
+ * 	Colors are counted by pixels, at the present's 15-bit precision, and
+ * 	the transparent color is left out. Does nothing in 24-bit modes.
+ *
+ * 	@param image Asset's image, NULL to gather nothing
+ */
+void vg_palette_gather(const Surface* image);
+
+/**
+ * 	@brief Gathers an indexed asset's colors for an 8-bit mode's palette
+ *
+ * 	@param image Asset's image, NULL to gather nothing
+ * 	@see vg_palette_gather()
+ */
+void vg_palette_gather_indexed(const IndexedSurface* image);
+
+/**
+ * 	@brief Adapts an 8-bit mode's palette to the colors gathered
+ *
+ * 	Entries after the color cube and the fixed colors are given the
+ * 	gathered colors whose pixels are worst served by the palette so far,
+ * 	one at a time, so colors covering more of the screens weigh more. The
+ * 	colors gathered are then discarded. Does nothing if none were.
+ *
+ * 	@return Returns 0 upon success, non-zero if the palette couldn't be set
+ */
+int vg_palette_adapt();
+
+/**
+ * 	@brief Discards the colors gathered without adapting the palette
+ */
+void vg_palette_discard();
+
 /**@}*/
 
 #endif /* __VIDEO_GR_H */
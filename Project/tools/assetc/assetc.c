@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "asset.h"
+#include "stbi_png.h"
+#include "parallel.h"
+
+/** Converts a PNG image into its raw twin, on a worker thread */
+static void convert(void* context, unsigned int index) {
+
+	char** paths = (char **) context;
+	const char* path = paths[index];
+	char raw_path[ASSET_PATH_MAX];
+	asset_raw_path(path, raw_path, ASSET_PATH_MAX);
+
+	Surface* surface = asset_decode_png(path, NULL);
+	stbi_png_cleanup();
+	if (surface == NULL) {
+		printf("Couldn't decode \"%s\"!\n", path);
+		paths[index] = NULL;
+		return;
+	}
+
+	if (asset_write_raw(surface, raw_path, path) != 0)
+		paths[index] = NULL;
+	else
+		printf("%s -> %s (%dx%d)\n", path, raw_path, surface->width,
+				surface->height);
+
+	surface_destroy(surface);
+}
+
+/**
+ * Converts PNG images into raw assets, stored next to them with the
+ * ".raw" extension, so the game reads them instead of decoding them.
+ * Images are converted concurrently, one per worker thread.
+ *
+ * Usage: assetc <image.png>...
+ */
+int main(int argc, char* argv[]) {
+
+	if (argc < 2) {
+		printf("Usage: %s <image.png>...\n", argv[0]);
+		return 1;
+	}
+
+	/* failed conversions clear their path */
+	parallel_run(argc - 1, convert, argv + 1);
+
+	int failed = 0;
+	int i;
+	for (i = 1; i < argc; i++)
+		failed |= argv[i] == NULL;
+
+	return failed;
+}
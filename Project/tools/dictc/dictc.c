@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "dictionary.h"
+
+#define RARITY_MAX		5		/* rarity of the rarest letters */
+#define SCORE_SCALE		256		/* scores' fixed-point scale */
+#define SCORE_MAX		(RARITY_MAX * SCORE_SCALE)	/* highest possible score */
+
+/** Rarity of each letter in English words, 1 for the most common ones */
+static const unsigned char rarity[26] = {
+	/* A  B  C  D  E  F  G  H  I  J  K  L  M  N  O  P  Q  R  S  T  U  V  W  X  Y  Z */
+	   1, 3, 2, 2, 1, 3, 3, 1, 1, 5, 4, 2, 2, 1, 1, 3, 5, 1, 1, 1, 2, 4, 3, 5, 3, 5
+};
+
+/** Scores a word's difficulty, its letters' mean rarity. A repeated letter
+ * counts once, since eating any of its copies first is allowed */
+static unsigned int score(const char* word, unsigned int length) {
+
+	uint32_t seen = 0;
+	unsigned int sum = 0, i;
+	for (i = 0; i < length; i++) {
+		unsigned int letter = toupper((unsigned char) word[i]) - 'A';
+		if (seen & (1u << letter))
+			continue;
+		seen |= 1u << letter;
+		sum += rarity[letter];
+	}
+
+	return sum * SCORE_SCALE / length;
+}
+
+/**
+ * Compiles a words file into the game's dictionary. Words are scored by
+ * their letters' rarity and split into DICT_LEVELS difficulty levels of
+ * about the same size, then sorted into buckets by length and level, so
+ * the game draws a word of either without scanning the list. Letters are
+ * stored in uppercase.
+ *
+ * Usage: dictc <words.txt> <output.dict>
+ */
+int main(int argc, char* argv[]) {
+
+	if (argc != 3) {
+		printf("Usage: %s <words.txt> <output.dict>\n", argv[0]);
+		return 1;
+	}
+
+	Dictionary* dictionary = dictionary_load(argv[1], argv[1], 0);
+	if (dictionary == NULL)
+		return 1;
+
+	unsigned int n_words = dictionary->n_words, length, i, j;
+	unsigned int* scores = (unsigned int *) malloc(n_words * sizeof(unsigned int) + 1);
+	unsigned int* below = (unsigned int *) calloc(SCORE_MAX + 2, sizeof(unsigned int));
+	DictWord* words = (DictWord *) malloc(n_words * sizeof(DictWord) + 1);
+	DictHeader header;
+	memset(&header, 0, sizeof(DictHeader));
+	if (scores == NULL || below == NULL || words == NULL)
+		return 1;
+
+	/* counts the words scoring lower than each score */
+	for (i = 0; i < n_words; i++) {
+		const char* word = dictionary_word(dictionary, i, &length);
+		scores[i] = score(word, length);
+		below[scores[i] + 1]++;
+	}
+	for (i = 1; i <= SCORE_MAX + 1; i++)
+		below[i] += below[i - 1];
+
+	/* words of the same score share a level, levels by rank */
+	unsigned int n_letters = 0;
+	for (i = 0; i < n_words; i++) {
+		dictionary_word(dictionary, i, &length);
+		unsigned int level = (unsigned long) below[scores[i]] * DICT_LEVELS / n_words;
+		scores[i] = dictionary_bucket(length, level);
+		header.buckets[scores[i] + 1]++;
+		n_letters += length;
+	}
+	for (i = 1; i <= DICT_BUCKETS; i++)
+		header.buckets[i] += header.buckets[i - 1];
+
+	/* words are laid out by bucket, keeping the file's order within each */
+	unsigned int* order = (unsigned int *) malloc(n_words * sizeof(unsigned int) + 1);
+	char* text = (char *) malloc(n_letters + 1);
+	if (order == NULL || text == NULL)
+		return 1;
+
+	uint32_t next[DICT_BUCKETS];
+	memcpy(next, header.buckets, sizeof(next));
+	for (i = 0; i < n_words; i++)
+		order[next[scores[i]]++] = i;
+
+	uint32_t offset = 0;
+	for (i = 0; i < n_words; i++) {
+		const char* word = dictionary_word(dictionary, order[i], &length);
+		words[i].offset = offset;
+		words[i].length = length;
+		for (j = 0; j < length; j++)
+			text[offset++] = toupper((unsigned char) word[j]);
+	}
+
+	header.magic = DICT_MAGIC;
+	header.version = DICT_VERSION;
+	header.n_words = n_words;
+	header.text_size = n_letters;
+
+	FILE* file = fopen(argv[2], "wb");
+	if (file == NULL) {
+		printf("Couldn't create \"%s\"!\n", argv[2]);
+		return 1;
+	}
+
+	int failed = fwrite(&header, sizeof(DictHeader), 1, file) != 1
+			|| fwrite(words, sizeof(DictWord), n_words, file) != n_words
+			|| fwrite(text, 1, n_letters, file) != n_letters;
+	if (fclose(file) != 0 || failed) {
+		printf("Couldn't write \"%s\"!\n", argv[2]);
+		return 1;
+	}
+
+	/* words per length, one column per level */
+	for (i = 1; i <= DICT_LENGTHS; i++) {
+		printf("%2u%s letters:", i, i == DICT_LENGTHS ? "+" : " ");
+		for (j = 0; j < DICT_LEVELS; j++) {
+			unsigned int bucket = dictionary_bucket(i, j);
+			printf(" %8u", header.buckets[bucket + 1] - header.buckets[bucket]);
+		}
+		printf("\n");
+	}
+
+	free(order);
+	free(text);
+	free(words);
+	free(below);
+	free(scores);
+	dictionary_destroy(dictionary);
+	return 0;
+}
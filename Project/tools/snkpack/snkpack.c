@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "asset.h"
+#include "pack.h"
+#include "stbi_png.h"
+#include "parallel.h"
+
+/* rounds an offset up to the pack's alignment */
+#define PACK_ALIGN(n)	(((n) + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1))
+
+/** Reads a whole file into memory */
+static char* read_file(const char* path, size_t* size) {
+
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* data = (char *) malloc(length > 0 ? length : 1);
+	if (data == NULL || fread(data, 1, length, file) != (size_t) length) {
+		free(data);
+		fclose(file);
+		return NULL;
+	}
+
+	fclose(file);
+	*size = length;
+	return data;
+}
+
+/** Converts a PNG into an indexed raw asset, header included, NULL if it has
+ * too many colors or indexing it wouldn't save memory */
+static char* convert_indexed(const Surface* surface, const char* path, size_t* size) {
+
+	size_t n_pixels = (size_t) surface->width * surface->height;
+	size_t palette = INDEXED_COLORS * SURFACE_BYTES_PER_PIXEL;
+	if (n_pixels + palette >= n_pixels * SURFACE_BYTES_PER_PIXEL)
+		return NULL;
+
+	IndexedSurface* indexed = surface_index(surface, NULL, 0);
+	if (indexed == NULL)
+		return NULL;
+
+	char* data = (char *) malloc(sizeof(AssetHeader) + palette + n_pixels);
+	if (data == NULL || asset_make_header((AssetHeader *) data, surface, path) != 0) {
+		free(data);
+		indexed_destroy(indexed);
+		return NULL;
+	}
+
+	AssetHeader* header = (AssetHeader *) data;
+	header->magic = ASSET_INDEXED_MAGIC;
+	header->pitch = indexed->pitch;
+	memcpy(data + sizeof(AssetHeader), indexed->palette, palette);
+	memcpy(data + sizeof(AssetHeader) + palette, indexed->indices, n_pixels);
+	*size = sizeof(AssetHeader) + palette + n_pixels;
+	indexed_destroy(indexed);
+	return data;
+}
+
+/** Returns a path's file name */
+static const char* file_name(const char* path) {
+
+	const char* name = strrchr(path, '/');
+	return name != NULL ? name + 1 : path;
+}
+
+/* suffixes naming the variants of a PNG, stored as patches of it */
+static const char* variant_suffixes[] = { "_play.png", "_exit.png" };
+
+/** Finds the PNG another one is a variant of, "menu_play.png" being a
+ * variant of "menu.png" when both are packed, NULL if there's none */
+static const char* find_base(const char* path, int argc, char* argv[]) {
+
+	const char* name = file_name(path);
+	size_t name_len = strlen(name), len = 0;
+	unsigned int k;
+	for (k = 0; k < sizeof(variant_suffixes) / sizeof(variant_suffixes[0]); k++) {
+		size_t suffix_len = strlen(variant_suffixes[k]);
+		if (name_len > suffix_len && strcmp(name + name_len - suffix_len,
+				variant_suffixes[k]) == 0) {
+			len = name_len - suffix_len;
+			break;
+		}
+	}
+	if (len == 0)
+		return NULL;
+
+	int i;
+	for (i = 2; i < argc; i++) {
+		const char* other = file_name(argv[i]);
+		if (strncmp(other, name, len) == 0 && strcmp(other + len, ".png") == 0)
+			return argv[i];
+	}
+
+	return NULL;
+}
+
+/** Converts a PNG into a raw patch of its base image, header included,
+ * NULL if their sizes differ or they're equal */
+static char* convert_patch(const Surface* variant, const char* path,
+		const char* base_path, size_t* size) {
+
+	Surface* base = asset_decode_png(base_path, NULL);
+	if (base == NULL)
+		return NULL;
+
+	int x, y, width, height;
+	if (base->width != variant->width || base->height != variant->height
+			|| !surface_diff_rect(base, variant, &x, &y, &width, &height)) {
+		surface_destroy(base);
+		return NULL;
+	}
+	surface_destroy(base);
+
+	Patch* patch = asset_make_patch(variant, x, y, width, height, NULL);
+	if (patch == NULL)
+		return NULL;
+
+	size_t n_bytes = (size_t) patch->pixels->pitch * height;
+	char* data = (char *) malloc(sizeof(PatchHeader) + n_bytes);
+	PatchHeader* header = (PatchHeader *) data;
+	if (data == NULL || asset_make_header(&header->image, patch->pixels, path) != 0) {
+		free(data);
+		free(patch);
+		return NULL;
+	}
+
+	header->image.magic = ASSET_PATCH_MAGIC;
+	header->x = x;
+	header->y = y;
+	memcpy(data + sizeof(PatchHeader), patch->pixels->pixels, n_bytes);
+	*size = sizeof(PatchHeader) + n_bytes;
+	free(patch);
+	return data;
+}
+
+/** Converts a PNG into a raw asset, header included, as a patch of its base
+ * image or indexed if possible */
+static char* convert_png(const char* path, const char* base_path, size_t* size,
+		pack_format_t* format) {
+
+	Surface* surface = asset_decode_png(path, NULL);
+	if (surface == NULL)
+		return NULL;
+
+	char* data = base_path != NULL ? convert_patch(surface, path, base_path, size) : NULL;
+	if (data != NULL) {
+		*format = PACK_PATCH;
+		surface_destroy(surface);
+		return data;
+	}
+
+	data = convert_indexed(surface, path, size);
+	if (data != NULL) {
+		*format = PACK_INDEXED;
+		surface_destroy(surface);
+		return data;
+	}
+
+	*format = PACK_IMAGE;
+	size_t n_bytes = (size_t) surface->pitch * surface->height;
+	data = (char *) malloc(sizeof(AssetHeader) + n_bytes);
+	if (data == NULL || asset_make_header((AssetHeader *) data, surface, path) != 0) {
+		free(data);
+		surface_destroy(surface);
+		return NULL;
+	}
+
+	memcpy(data + sizeof(AssetHeader), surface->pixels, n_bytes);
+	*size = sizeof(AssetHeader) + n_bytes;
+	surface_destroy(surface);
+	return data;
+}
+
+/**
+ * @brief Files being converted into the pack's entries
+*/
+typedef struct Conversion {
+	int argc;				/**< Number of command line arguments */
+	char** argv;			/**< Command line arguments, files from the third on */
+	PackEntry* entries;		/**< Entries, their sizes, formats and checksums set */
+	char** data;			/**< Entries' data, NULL if the file couldn't be read */
+} Conversion;
+
+/** Converts a file into a pack entry's data, on a worker thread */
+static void convert(void* context, unsigned int index) {
+
+	Conversion* conversion = (Conversion *) context;
+	const char* path = conversion->argv[index + 2];
+	const char* name = file_name(path);
+	size_t len = strlen(name), size = 0;
+	pack_format_t format = PACK_DATA;
+	char* data;
+
+	if (len >= 4 && strcmp(name + len - 4, ".png") == 0) {
+		data = convert_png(path, find_base(path, conversion->argc, conversion->argv),
+				&size, &format);
+		stbi_png_cleanup();
+	} else
+		data = read_file(path, &size);
+
+	conversion->data[index] = data;
+	if (data != NULL) {
+		conversion->entries[index].size = size;
+		conversion->entries[index].format = format;
+		conversion->entries[index].checksum = pack_checksum(data, size);
+	}
+}
+
+/**
+ * Builds the asset pack. PNG images are stored already converted to the
+ * framebuffer's native format, or palette-indexed when they have few enough
+ * colors and are large enough to benefit. A PNG named after another one plus
+ * one of the variant suffixes ("_play", "_exit"), with the same size, is
+ * stored as a patch of it: only the rectangle where they differ. Any other file is stored as is. Files are
+ * converted concurrently, one per worker thread. Entries are
+ * named after the files' names.
+ *
+ * Usage: snkpack <output.pack> <file>...
+ */
+int main(int argc, char* argv[]) {
+
+	if (argc < 3) {
+		printf("Usage: %s <output.pack> <file>...\n", argv[0]);
+		return 1;
+	}
+
+	unsigned int n_entries = argc - 2;
+	PackEntry* entries = (PackEntry *) calloc(n_entries, sizeof(PackEntry));
+	char** data = (char **) calloc(n_entries, sizeof(char *));
+	if (entries == NULL || data == NULL)
+		return 1;
+
+	/* data starts right after the index */
+	uint32_t offset = PACK_ALIGN(sizeof(PackHeader) + n_entries * sizeof(PackEntry));
+
+	unsigned int i;
+	for (i = 0; i < n_entries; i++) {
+		if (strlen(file_name(argv[i + 2])) >= PACK_NAME_MAX) {
+			printf("Name \"%s\" is too long!\n", file_name(argv[i + 2]));
+			return 1;
+		}
+	}
+
+	/* files are converted concurrently, then laid out in order */
+	Conversion conversion;
+	conversion.argc = argc;
+	conversion.argv = argv;
+	conversion.entries = entries;
+	conversion.data = data;
+	parallel_run(n_entries, convert, &conversion);
+
+	for (i = 0; i < n_entries; i++) {
+		if (data[i] == NULL) {
+			printf("Couldn't read \"%s\"!\n", argv[i + 2]);
+			return 1;
+		}
+
+		const char* name = file_name(argv[i + 2]);
+		strncpy(entries[i].name, name, PACK_NAME_MAX);
+		entries[i].offset = offset;
+		offset = PACK_ALIGN(offset + entries[i].size);
+
+		printf("%-*s %8u bytes at %8u\n", PACK_NAME_MAX, name, entries[i].size,
+				entries[i].offset);
+	}
+
+	PackHeader header;
+	header.magic = PACK_MAGIC;
+	header.version = PACK_VERSION;
+	header.n_entries = n_entries;
+	header.size = offset;
+
+	FILE* file = fopen(argv[1], "wb");
+	if (file == NULL) {
+		printf("Couldn't create \"%s\"!\n", argv[1]);
+		return 1;
+	}
+
+	/* zero padding up to each aligned offset */
+	static const char padding[PACK_ALIGNMENT];
+	long position = sizeof(PackHeader) + n_entries * sizeof(PackEntry);
+	int failed = fwrite(&header, sizeof(PackHeader), 1, file) != 1
+			|| fwrite(entries, sizeof(PackEntry), n_entries, file) != n_entries;
+
+	for (i = 0; i < n_entries && !failed; i++) {
+		failed = fwrite(padding, 1, entries[i].offset - position, file)
+				!= entries[i].offset - position
+				|| fwrite(data[i], 1, entries[i].size, file) != entries[i].size;
+		position = entries[i].offset + entries[i].size;
+		free(data[i]);
+	}
+	if (!failed)
+		failed = fwrite(padding, 1, header.size - position, file) != header.size - position;
+
+	if (fclose(file) != 0 || failed) {
+		printf("Couldn't write \"%s\"!\n", argv[1]);
+		return 1;
+	}
+
+	return 0;
+}